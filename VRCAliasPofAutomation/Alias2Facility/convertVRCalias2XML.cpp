@@ -14,6 +14,8 @@ Description: Converts VRC alias text files to XML and inserts that XML
 #ifdef _WIN32
 #define NOMINMAX
 #include <Windows.h>
+#include <io.h>
+#include <fcntl.h>
 #include <bitcompressor.hpp> //Release version:3.1.2 - https://github.com/rikyoz/bit7z
 #include <bitstreamcompressor.hpp>
 #include <bitextractor.hpp>
@@ -24,6 +26,11 @@ using bit7z::BitCompressor;
 using bit7z::BitStreamCompressor;
 using bit7z::BitExtractor;
 using bit7z::BitException;
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #include <limits>
@@ -38,6 +45,35 @@ using bit7z::BitException;
 #include <chrono>
 #include <ctime>
 #include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <charconv>
+
+//x86 builds get SSE2/AVX2 scanners, picked at runtime
+//  everything else uses the scalar versions
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define X86_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 
 using namespace std;
 using std::filesystem::path;
@@ -50,21 +86,523 @@ using chrono::duration;
 //////////////////////////////////////////////////////////////////////////////
 //STRUCTS & CLASSES
 //////////////////////////////////////////////////////////////////////////////
+//deduplicated strings as a structure of arrays
+//  each distinct string is XML escaped once and stored once in the char
+//  arena, a handle is its index into the ...Lst columns
+//found through an open addressing (linear probing) index of handles
+//  keyed by the unescaped strings as they were interned... those are NOT
+//  copied (views into the caller's buffer, so it has to outlive the pool)
+typedef struct XMLStrPool {
+public:
+  XMLStrPool();
+  //rtns the handle of str, escaping and adding it if it is new
+  uint32_t intern(string_view str);
+  //the escaped string of handle
+  string_view str(uint32_t handle) const {
+    return string_view(arena.data() + strIdxLst[handle], strLenLst[handle]);
+  }
+
+  string arena;
+  vector<uint32_t> strIdxLst;
+  vector<uint32_t> strLenLst;
+  vector<string_view> keyLst;   //unescaped, per handle
+  vector<uint32_t> hashLst;
+  vector<uint32_t> slotLst;     //handles, NO_HANDLE means the slot is free
+  size_t slotMask = 0;
+} XMLStrPool;
+
+//the positionType of a sector ID (see Config::classify())
+//  the names written for them are SECTOR_CLASS_NAME_LST
+enum class SectorClass : uint8_t { OTHER, IN_FACILITY, ADJACENT };
+
 //represents all of the attributes of the vSTARS PositionInfo XML entity
+//radioName, prefix, suffix and sectorID repeat thousands of times in a
+//  POF, so they are handles into an XMLStrPool (see initPosition()) that
+//  holds each of them once, already escaped
+//sectorName is different for every position, so it stays a view into
+//  the POF line (escaped as it is appended)
 typedef struct Position{
 public:
-  string sectorName, radioName, prefix, suffix, sectorID, positionType;
+  string_view sectorName;
+  uint32_t radioName = 0, prefix = 0, suffix = 0, sectorID = 0;
+  SectorClass positionType = SectorClass::OTHER;
   char posSym = '\0';
-  float freq = -1.0;
+  //false if the POF frequency could not be parsed (freq is NO_FREQ)
+  bool isFreqOK = true;
+  //kHz above 100 MHz, i.e. (MHz - 100) * 1000... kept as an integer
+  //  so every channel is exact (see parseFreq())
+  int32_t freq = 0;
 } Position;
 
+//the sector ID lists are kept as they were read (they are written back
+//  to new cfg files), and are also compiled into sectorClassTbl, which
+//  every sector ID lookup goes through
 typedef struct Config {
 public:
+  //rtns the SectorClass of sectorID... Adjacent wins if it is in both lists
+  //  an ID of up to MAX_PACKED_SECTOR_ID_LEN chars (all real ones) is
+  //  packed into a uint32 and found in sectorClassTbl, longer ones fall
+  //  back to the lists
+  SectorClass classify(string_view sectorID) const;
+  //(re)builds sectorClassTbl from the lists... call after they change
+  void buildSectorClassTbl();
+
   unordered_set<string> inFacilityLst;
   unordered_set<string> adjacentLst;
+  //open addressing (linear probing) table of the packed sector IDs
+  //  each slot is a packSectorID() key with its SectorClass in the bits
+  //  above SECTOR_KEY_MASK, 0 means the slot is free
+  vector<uint32_t> sectorClassTbl;
+  uint32_t sectorClassMask = 0;
+  //set by initCfg() once the lists are loaded (or the user chose to go
+  //  on without them)... if not, the Positions blocks are kept as they are
+  bool isSet = false;
 } Config;
 
+//the fixed text of one kind of XML element (its indent, tag, attribute
+//  names and the quotes around each value) joined at compile time
+//  into one fragment per attribute... frag(attrIdx) goes right before
+//  the value of that attribute and frag(AttrCnt) closes the element
+//see appendXMLElem()
+template <size_t AttrCnt>
+struct XMLElemFmt {
+public:
+  array<char, 256> text = {};
+  array<uint16_t, AttrCnt + 2> fragIdxLst = {};
+
+  constexpr XMLElemFmt(
+    string_view indent, string_view tag, array<string_view, AttrCnt> const& attrLst
+  ) {
+    size_t textLen = 0;
+    auto add = [&](string_view str) { for (char chr : str) text[textLen++] = chr; };
+    add(indent);
+    add("<");
+    add(tag);
+    //LOOP THRU ATTRIBUTES
+    for (size_t attrIdx = 0; attrIdx < AttrCnt; ++attrIdx) {
+      if (attrIdx > 0) add("\"");
+      add(" ");
+      add(attrLst[attrIdx]);
+      add("=\"");
+      fragIdxLst[attrIdx + 1] = static_cast<uint16_t>(textLen);
+    }//END LOOP THRU ATTRIBUTES
+    add("\" />");
+    fragIdxLst[AttrCnt + 1] = static_cast<uint16_t>(textLen);
+  }
+  constexpr string_view frag(size_t fragIdx) const {
+    return string_view(text.data() + fragIdxLst[fragIdx], fragIdxLst[fragIdx + 1] - fragIdxLst[fragIdx]);
+  }
+  //the length of an element of this kind with all values empty
+  constexpr size_t fixedLen() const { return fragIdxLst[AttrCnt + 1]; }
+};
+
+//an attribute value appendXMLElem() appends as is
+//  (it is already escaped, or can not contain anything to escape)
+typedef struct XMLRaw {
+public:
+  string_view str;
+} XMLRaw;
+
+//command line switches
+//  they all start with -- and may be given anywhere in the arg list
+typedef struct Options {
+public:
+  bool dropDups = false; //--drop-dups: only keep the last of duplicate aliases
+  bool useCache = true;  //--no-cache: neither read nor write .v2xalias files
+  bool lint = true;      //--no-lint: do not check the alias replacements
+  //--lint-strict: problems the lint finds make the exit status nonzero
+  //  (ALIAS_LINT)... otherwise they are only warnings
+  bool lintStrict = false;
+  //--expand=CtxPath: expand the commands read from stdin instead of
+  //  updating facility files... see runAliasExpand()
+  string expandCtxPath;
+  //--query: print the aliases that start with each prefix read from stdin
+  //  instead of updating facility files... see runAliasQuery()
+  bool query = false;
+  //--shadows: report the commands that are a prefix of other commands
+  bool shadows = false;
+  //--compact: write the CommandAliases and Positions blocks without
+  //  indentation (smaller to write, compress and ship)
+  bool compact = false;
+  //--cfg=CfgPath: the .v2xcfg to classify the positions with, instead
+  //  of DEFAULT_CFG... see initCfg()
+  path cfgPath;
+} Options;
+
 enum class InfoType { NONE, CMDS, POS };
+//encoding detected for an input file by normalizeInBuf()
+enum class TextEnc { ASCII, UTF8, CP1252, UTF16 };
+
+//location of one dot (.) line inside a VRC alias buffer
+//  produced by scanAliasLines()
+typedef struct AliasLineIdx {
+public:
+  size_t lineIdx = 0;    //offset of the '.' that starts the line
+  uint32_t lineLen = 0;  //excluding the \n or \r\n terminator
+  uint32_t splitLen = 0; //offset of the first ' ' in the line, or NO_SPLIT
+  uint32_t lineNum = 0;  //1 based line number, for messages
+} AliasLineIdx;
+
+//read-only view of an entire input file
+//memory-mapped when possible, otherwise filled by a single bulk read
+//  either way, view() stays valid for the lifetime of the InFileBuf
+typedef struct InFileBuf {
+public:
+  InFileBuf() = default;
+  InFileBuf(InFileBuf&& other) noexcept;
+  InFileBuf& operator=(InFileBuf&& other) noexcept;
+  InFileBuf(InFileBuf const&) = delete;
+  InFileBuf& operator=(InFileBuf const&) = delete;
+  ~InFileBuf();
+
+  string_view view() const { return string_view(data_, size_); }
+
+  char const* data_ = nullptr;
+  size_t size_ = 0;
+  unique_ptr<char[]> bulkBuf_; //only used if the file could not be mapped
+  void* mapAddr_ = nullptr;
+  size_t mapLen_ = 0; //data_/size_ may be narrowed (BOM), the mapping is not
+#ifdef _WIN32
+  HANDLE mapHndl_ = NULL;
+#endif
+} InFileBuf;
+
+//one VRC alias source file and the dot (.) lines found in it
+typedef struct AliasSrc {
+public:
+  path srcPath;
+  InFileBuf buf;
+  vector<AliasLineIdx> lineLst;
+  TextEnc enc = TextEnc::ASCII;
+  uint64_t rawSize = 0; //size and hashBytes() of the file as it was read
+  uint64_t rawHash = 0; //  (the key of the .v2xalias cache)
+} AliasSrc;
+
+//kinds of AliasTok
+enum class AliasTokKind : uint8_t { TEXT, VAR, PARAM, FUNC, CALL_END };
+//one token of an alias replacement (ReplaceWith) body
+//  produced by tokenizeAliasBody()
+typedef struct AliasTok {
+public:
+  AliasTokKind kind = AliasTokKind::TEXT;
+  uint32_t idx = 0; //offset into the body
+  uint32_t len = 0; //VAR/PARAM include the '$', FUNC the '$' and the '('
+} AliasTok;
+
+//one VRC alias variable or function, see ALIAS_BUILTIN_LST
+typedef struct AliasBuiltin {
+public:
+  string_view name; //lower case, without the '$'
+  bool isFunc;
+} AliasBuiltin;
+
+//one alias that survived the merge of all AliasSrcs
+typedef struct AliasRef {
+public:
+  uint32_t srcIdx = 0;  //index into the AliasSrc list
+  uint32_t lineIdx = 0; //index into AliasSrc::lineLst
+} AliasRef;
+
+//all of the aliases as a structure of arrays
+//  the (XML escaped) commands and replacements are stored back to back
+//  in one char arena, an alias is just 4 offsets/lengths into it
+//arena and the ...Lst columns point into either the owners below
+//  or a mapped .v2xalias cache
+typedef struct AliasTable {
+public:
+  string_view cmd(size_t aliasIdx) const {
+    return string_view(arena + cmdIdxLst[aliasIdx], cmdLenLst[aliasIdx]);
+  }
+  string_view rplcmnt(size_t aliasIdx) const {
+    return string_view(arena + rplcmntIdxLst[aliasIdx], rplcmntLenLst[aliasIdx]);
+  }
+  //points arena and the columns at the owners (after they were filled)
+  void useOwners();
+
+  size_t aliasCnt = 0;
+  char const* arena = nullptr;
+  size_t arenaLen = 0;
+  uint32_t const* cmdIdxLst = nullptr;
+  uint32_t const* cmdLenLst = nullptr;
+  uint32_t const* rplcmntIdxLst = nullptr;
+  uint32_t const* rplcmntLenLst = nullptr;
+  //where each alias came from... only while the table is built, not cached
+  vector<AliasRef> refLst;
+  uint32_t dupCnt = 0;      //from the merge
+  uint32_t overrideCnt = 0;
+  uint32_t lintCnt = 0;     //problems found by lintAliasBody()
+
+  string arenaOwner;
+  vector<uint32_t> cmdIdxOwner;
+  vector<uint32_t> cmdLenOwner;
+  vector<uint32_t> rplcmntIdxOwner;
+  vector<uint32_t> rplcmntLenOwner;
+  InFileBuf cacheBuf;
+} AliasTable;
+
+//which aliases run which other aliases, as adjacency lists
+//  alias A refs alias B if the replacement of A starts with the command
+//  of B (the client runs the result of A as a command again)
+typedef struct AliasGraph {
+public:
+  explicit AliasGraph(AliasTable const& aliasTable);
+
+  //refs of alias n are edgeLst[firstEdgeLst[n]...firstEdgeLst[n + 1])
+  vector<uint32_t> firstEdgeLst;
+  vector<uint32_t> edgeLst;
+} AliasGraph;
+
+//the alias commands in (case-insensitive) sorted order
+//  so all of the commands that start with a prefix are one range
+//the commands are unescaped copies, the table is not needed after the
+//  constructor (aliasIdxLst still refers to its aliases)
+typedef struct CmdPrefixIdx {
+public:
+  explicit CmdPrefixIdx(AliasTable const& aliasTable);
+  //[first, last) of the sorted commands that start with prefix
+  pair<size_t, size_t> findPrefix(string_view prefix) const;
+  //the command at sortedIdx, as it was written
+  string_view cmd(size_t sortedIdx) const {
+    return string_view(cmdArena.data() + cmdIdxLst[sortedIdx], cmdLenLst[sortedIdx]);
+  }
+
+  string cmdArena;
+  vector<uint32_t> cmdIdxLst;   //in sorted order
+  vector<uint32_t> cmdLenLst;
+  vector<uint32_t> aliasIdxLst; //AliasTable index of each sorted command
+} CmdPrefixIdx;
+
+//layout of a .v2xalias cache file (native byte order, it never leaves
+//  the machine that wrote it):
+//  AliasCacheHdr, AliasCacheSrc[srcCnt], the 4 uint32_t columns of
+//  AliasTable (aliasCnt each), then arenaLen bytes of AliasTable::arena
+typedef struct AliasCacheHdr {
+public:
+  char magic[8];        //ALIAS_CACHE_MAGIC
+  uint32_t version;     //ALIAS_CACHE_VERSION
+  uint32_t flags;       //the options the cache was built with (ALIAS_CACHE_*)
+  uint32_t srcCnt;
+  uint32_t aliasCnt;
+  uint32_t dupCnt;      //from the merge and the lint,
+  uint32_t overrideCnt; //  so a cache hit can report them too
+  uint32_t lintCnt;
+  uint32_t reserved;    //0... keeps the header a multiple of 8 bytes
+  uint64_t arenaLen;
+  uint64_t payloadHash; //hashBytes() of everything after the header
+} AliasCacheHdr;
+typedef struct AliasCacheSrc {
+public:
+  uint64_t rawSize;
+  uint64_t rawHash;
+} AliasCacheSrc;
+
+//reads a stream (stdin or a named pipe) a line at a time
+//  through one fixed size buffer, so memory use does not depend on
+//  how much is read... a line can be up to bufLen bytes (the buffer
+//  has room for its \r\n on top of that)
+typedef struct LineStrmReader {
+public:
+  LineStrmReader(FILE* strm, size_t bufLen);
+  //pops the next line (without its \n or \r\n terminator)
+  //  line is only valid until the next call
+  //rtns false at the end of the stream, on a read error (see strm)
+  //  or if the line is longer than bufLen (see lineTooLong)
+  bool nextLine(string_view& line);
+
+  FILE* strm = nullptr;
+  unique_ptr<char[]> buf;
+  size_t bufLen = 0;  //the longest line
+  size_t bufCap = 0;  //bufLen and a \r\n
+  size_t headIdx = 0; //first byte not handed out yet
+  size_t scanIdx = 0; //bytes before this were already searched for \n
+  size_t tailIdx = 0; //one past the last byte read
+  uint32_t lineNum = 0;
+  bool atEOF = false;
+  bool lineTooLong = false;
+} LineStrmReader;
+
+//case-insensitive hash and compare of alias commands
+//  so .CTM and .ctm end up in the same slot of a command index
+typedef struct CmdHash {
+public:
+  size_t operator()(string_view cmd) const;
+} CmdHash;
+typedef struct CmdEq {
+public:
+  bool operator()(string_view lhs, string_view rhs) const;
+} CmdEq;
+
+//open addressing (linear probing) index of alias commands
+//  sized once for the number of aliases so it never rehashes
+//the commands are NOT copied... they must outlive the index
+typedef struct CmdIdx {
+public:
+  explicit CmdIdx(size_t maxCmdCnt);
+  //finds cmd or, if it is not in the index yet, adds it with val
+  //rtns the value stored for cmd (can be updated through the reference)
+  uint32_t& findOrAdd(string_view cmd, uint32_t val, bool& isNew);
+  //finds cmd without adding it
+  //rtns the value stored for cmd or nullptr if cmd is not in the index
+  uint32_t const* find(string_view cmd) const;
+
+  typedef struct Slot {
+  public:
+    char const* cmd = nullptr; //nullptr means the slot is free
+    uint32_t cmdLen = 0;
+    uint32_t hash = 0;
+    uint32_t val = 0;
+  } Slot;
+  vector<Slot> slotLst;
+  size_t slotMask = 0;
+} CmdIdx;
+
+//kinds of ExpandOp
+enum class ExpandOpKind : uint8_t { TEXT, VAR, PARAM, CALL, CALL_END };
+//one instruction of a compiled alias replacement, see AliasEngine
+typedef struct ExpandOp {
+public:
+  ExpandOpKind kind = ExpandOpKind::TEXT;
+  //VAR/CALL: index into ALIAS_BUILTIN_LST (NO_BUILTIN if not a built-in)
+  //PARAM: the parameter number
+  uint32_t val = 0;
+  //TEXT: the text, VAR/CALL: the name (without $ and ()
+  //  as an offset/length into AliasEngine::textArena
+  uint32_t idx = 0;
+  uint32_t len = 0;
+} ExpandOp;
+
+//the simulated state of the ATC client that aliases are expanded against
+typedef struct ExpandCtx {
+public:
+  //values of the built-in variables, by their ALIAS_BUILTIN_LST index
+  vector<string> builtinValLst;
+  //values of other variables, by their lower case name
+  unordered_map<string, string> varValLst;
+  //results of functions other than $uc()/$lc(), by their lower case
+  //  call... "freq(zny_ctr)" is the result of $freq(ZNY_CTR)
+  unordered_map<string, string> funcValLst;
+} ExpandCtx;
+
+//compiles every alias of an AliasTable into a list of ExpandOps once,
+//  so expanding a command is just running its ops against an ExpandCtx
+//the engine keeps its own (unescaped) copy of the commands and
+//  replacements, the table is not needed after the constructor
+typedef struct AliasEngine {
+public:
+  explicit AliasEngine(AliasTable const& aliasTable);
+  //expands cmdLine (a dot command and its parameters, as typed)
+  //  a replacement that is itself a known dot command is expanded again,
+  //  up to ALIAS_EXPAND_MAX_DEPTH times
+  //rtns false (expansion is left empty) if there is no alias for it
+  bool expand(string_view cmdLine, ExpandCtx const& ctx, string& expansion) const;
+  //runs the ops of one alias, appending to expansion
+  void run(
+    size_t aliasIdx, vector<string_view> const& paramLst,
+    ExpandCtx const& ctx, string& expansion
+  ) const;
+
+  string textArena;
+  vector<ExpandOp> opLst;
+  //ops of alias n are opLst[firstOpLst[n]...firstOpLst[n + 1])
+  vector<uint32_t> firstOpLst;
+  //offset/length of the command of each alias in textArena
+  vector<uint32_t> cmdIdxLst;
+  vector<uint32_t> cmdLenLst;
+  //alias index of every command (the last one if it is defined twice)
+  CmdIdx cmdIdx;
+} AliasEngine;
+
+//the worker threads of runTasks(), started once (on the first call that
+//  goes parallel) and reused by every call after that, so the thread
+//  start cost is paid once per run instead of once per pipeline stage
+//every worker takes part in every batch, so run() knows all of them
+//  are done with a batch before the next one can be started
+typedef struct WorkerPool {
+public:
+  ~WorkerPool();
+  //calls taskFn(0) ... taskFn(taskCnt - 1) on the workers and this thread
+  //  and rtns once all calls are done... NOT reentrant (a task must not
+  //  call run() again) and only called from the main thread
+  void run(size_t taskCnt, function<void(size_t)> const& taskFn);
+  //the loop of each worker thread
+  void work();
+
+  vector<thread> thrdLst;
+  mutex batchMutex;
+  condition_variable batchCond; //a new batch was started (or stop is set)
+  condition_variable doneCond;  //a worker finished the current batch
+  function<void(size_t)> const* taskFn = nullptr;
+  size_t taskCnt = 0;
+  atomic<size_t> nextTaskIdx{ 0 };
+  uint64_t batchNum = 0;
+  size_t doneCnt = 0;           //workers done with the current batch
+  bool stop = false;
+} WorkerPool;
+
+//a document that is never joined into one buffer... like an iovec list
+//  (see writev()) it is just the spans of other buffers, in order
+//  (e.g. the retained parts of a facility file and the new blocks)
+//the buffers must outlive the SpanLst
+typedef struct SpanLst {
+public:
+  //adds span to the end... merged into the last span if it starts
+  //  right where that one ends, so retained text stays one span
+  void push(string_view span);
+
+  vector<string_view> spanLst;
+  size_t len = 0; //of the whole document
+} SpanLst;
+
+//reads a SpanLst as one seekable stream (e.g. for the compressor)
+//  without joining its spans
+typedef struct SpanStrmBuf : public streambuf {
+public:
+  explicit SpanStrmBuf(SpanLst const& src) : src(src) {}
+
+  int_type underflow() override;
+  pos_type seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, ios_base::openmode which) override;
+
+  SpanLst const& src;
+  size_t nextSpanIdx = 0; //the span after the one in the get area
+  size_t spanPos = 0;     //document offset of the start of the get area
+} SpanStrmBuf;
+
+//checks that a document is well-formed XML as it is fed a span at a time
+//  (a tag or entity may be split across spans): one root element with
+//  only white space (and a leading BOM) outside of it, balanced tags,
+//  quoted attribute values, known entities and character references
+//  to characters XML allows
+//comments, <?...?>, <!...> declarations and CDATA are skipped over
+//the text and attribute values, i.e. nearly all of a facility file,
+//  are skipped with the vector scanner (see findXMLMarkupChar())
+typedef struct XMLValidator {
+public:
+  //rtns false once the document is found to be malformed (see errMsg)
+  bool feed(string_view span);
+  //call after the last span... rtns false if the document is malformed
+  bool finish();
+
+  enum class State : uint8_t {
+    TEXT, TAG_OPEN, TAG_NAME, IN_TAG, EMPTY_TAG_END,
+    ATTR_NAME, ATTR_EQ, ATTR_VAL_START, ATTR_VAL, AFTER_ATTR_VAL,
+    END_TAG_NAME, END_TAG_REST, ENTITY, BANG, SKIP
+  };
+  State state = State::TEXT;
+  State entityRtnState = State::TEXT; //the state the entity was found in
+  char quote = '\0';       //of the attribute value being read
+  string_view skipEnd;     //of the comment, <?...?> etc. being skipped
+  size_t skipMatchLen = 0; //how much of skipEnd was just read
+  string markup;           //the entity, end tag or <! prefix being read
+  //names of the open elements, back to back
+  string openTagArena;
+  vector<uint32_t> openTagIdxLst;
+  bool hasRoot = false;    //the root element was started
+  size_t bomMatchLen = 0;  //how much of a UTF-8 BOM the document starts with
+  size_t docPos = 0;       //document offset of the span being fed
+  size_t errPos = 0;       //document offset of the error
+  string errMsg;
+} XMLValidator;
 
 //////////////////////////////////////////////////////////////////////////////
 //CONSTANTS
@@ -80,10 +618,155 @@ int static const DELETE_FILE_FAILURE = 64;
 int static const FACILITY_FILE_FORMAT = 128;
 int static const CONFIG_FORMAT = 256;
 int static const TIME_STR_ERROR = 512;
+int static const DUP_ALIASES = 1024;
+int static const INPUT_ENCODING = 2048;
+int static const INPUT_LINE_LEN = 4096;
+int static const ALIAS_LINT = 16384;
+int static const ALIAS_CYCLE = 32768;
+int static const POF_FREQ = 65536;
 
 string static const DEFAULT_CFG = "default.v2xcfg";
+int static const POF_IDX = 2;
+//the first facility file when there is no POF (see getFacilityIdx())
 int static const FACILITY_IDX = 2;
 int static const UPDATE_TIME_STR_LEN = 34;
+//longest fmtFreq() output: -2147483648.000000
+size_t static const FREQ_STR_LEN = 18;
+//the frequency of a Position whose POF frequency is not a number
+//  (as if it was 0 MHz, which is what >> used to leave)
+int32_t static const NO_FREQ = -100000;
+//"00" "01" ... "99", so numbers can be formatted two digits at a time
+array<char, 200> static const DIGIT_PAIR_LST = [] {
+  array<char, 200> digitPairLst = {};
+  for (int pairIdx = 0; pairIdx < 100; ++pairIdx) {
+    digitPairLst[pairIdx * 2] = static_cast<char>('0' + pairIdx / 10);
+    digitPairLst[pairIdx * 2 + 1] = static_cast<char>('0' + pairIdx % 10);
+  }
+  return digitPairLst;
+}();
+//a free slot of the XMLStrPool index
+uint32_t static const NO_HANDLE = UINT32_MAX;
+//the positionType written for each SectorClass
+array<string_view, 3> static const SECTOR_CLASS_NAME_LST = { "Other", "InFacility", "Adjacent" };
+//a sector ID this long or shorter is packed into one uint32 (see
+//  packSectorID()): its chars in the low 3 bytes, its length above them
+size_t static const MAX_PACKED_SECTOR_ID_LEN = 3;
+uint32_t static const SECTOR_KEY_MASK = 0x03FFFFFF;
+int static const SECTOR_CLASS_SHIFT = 26;
+//AliasLineIdx::splitLen of a line with no ' ' in it
+uint32_t static const NO_SPLIT = UINT32_MAX;
+//alias buffers smaller than this per thread are not worth splitting up
+size_t static const MIN_CHUNK_LEN = 64 * 1024;
+//same idea, counted in aliases, for the conversion to XML
+size_t static const MIN_CHUNK_ALIASES = 1024;
+//buffer of the LineStrmReader used for streamed alias input
+//  also the longest alias line that can be streamed
+size_t static const STRM_BUF_LEN = 64 * 1024;
+//sidecar cache of the escaped alias table... see AliasCacheHdr
+string static const ALIAS_CACHE_EXT = ".v2xalias";
+char static const ALIAS_CACHE_MAGIC[8] = "V2XALIA";
+uint32_t static const ALIAS_CACHE_VERSION = 3;
+uint32_t static const ALIAS_CACHE_DROP_DUPS = 1;
+uint32_t static const ALIAS_CACHE_LINT = 2;
+//ExpandOp::val of a name that is not in ALIAS_BUILTIN_LST
+uint32_t static const NO_BUILTIN = UINT32_MAX;
+//how many times AliasEngine::expand() expands the result of an alias
+//  that is itself a dot command... stops alias cycles
+uint32_t static const ALIAS_EXPAND_MAX_DEPTH = 8;
+//the variables and functions VRC expands in alias replacements
+//  sorted by name, findAliasBuiltin() relies on that
+//  $1, $2... (the alias parameters) are not listed
+AliasBuiltin static const ALIAS_BUILTIN_LST[] = {
+  { "aircraft", false },
+  { "alt", false },
+  { "altim", true },
+  { "arr", false },
+  { "bear", true },
+  { "callsign", false },
+  { "calt", false },
+  { "com1", false },
+  { "cruise", false },
+  { "dep", false },
+  { "dist", true },
+  { "freq", true },
+  { "ftime", true },
+  { "lc", true },
+  { "metar", true },
+  { "myrealname", false },
+  { "oclock", true },
+  { "radioname", true },
+  { "route", false },
+  { "squawk", false },
+  { "temp", false },
+  { "time", false },
+  { "type", false },
+  { "uc", true },
+  { "wind", true },
+  { "winds", false },
+};
+//how many bytes escapeXML() adds for each character
+array<uint8_t, 256> static const ESC_XML_EXTRA_LEN = [] {
+  array<uint8_t, 256> extraLenLst = {};
+  extraLenLst['&'] = sizeof("&amp;") - 2;
+  extraLenLst['"'] = sizeof("&quot;") - 2;
+  extraLenLst['\''] = sizeof("&apos;") - 2;
+  extraLenLst['<'] = sizeof("&lt;") - 2;
+  return extraLenLst;
+}();
+//which characters may start (XML_NAME_START) or be in (XML_NAME_REST)
+//  an XML tag or attribute name... any non-ASCII byte is let thru,
+//  XML allows most of them
+uint8_t static const XML_NAME_START = 1;
+uint8_t static const XML_NAME_REST = 2;
+array<uint8_t, 256> static const XML_NAME_CHAR_LST = [] {
+  array<uint8_t, 256> nameCharLst = {};
+  for (int chr = 0; chr < 256; ++chr) {
+    if ((chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || chr == '_' || chr == ':' || chr >= 0x80)
+      nameCharLst[chr] = XML_NAME_START;
+    else if ((chr >= '0' && chr <= '9') || chr == '-' || chr == '.')
+      nameCharLst[chr] = XML_NAME_REST;
+  }
+  return nameCharLst;
+}();
+//what tokenizeAliasBody() has to stop at (ALIAS_TOK_STOP: $ ( and ))
+//  and what may be in a $name (ALIAS_TOK_NAME, ALIAS_TOK_DIGIT for $1...)
+//  so one table lookup per character does the scan
+uint8_t static const ALIAS_TOK_STOP = 1;
+uint8_t static const ALIAS_TOK_NAME = 2;
+uint8_t static const ALIAS_TOK_DIGIT = 4;
+array<uint8_t, 256> static const ALIAS_TOK_CHAR_LST = [] {
+  array<uint8_t, 256> tokCharLst = {};
+  tokCharLst['$'] = tokCharLst['('] = tokCharLst[')'] = ALIAS_TOK_STOP;
+  for (int chr = 0; chr < 256; ++chr) {
+    if ((chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z')) tokCharLst[chr] = ALIAS_TOK_NAME;
+    else if (chr >= '0' && chr <= '9') tokCharLst[chr] = ALIAS_TOK_NAME | ALIAS_TOK_DIGIT;
+  }
+  return tokCharLst;
+}();
+//<CommandAlias Command="..." ReplaceWith="..." />
+constexpr XMLElemFmt<2> COMMAND_ALIAS_FMT(
+  "      ", "CommandAlias", { "Command", "ReplaceWith" }
+);
+constexpr XMLElemFmt<2> COMMAND_ALIAS_COMPACT_FMT(
+  "", "CommandAlias", { "Command", "ReplaceWith" }
+);
+//<PositionInfo PositionType="..." ... PositionSymbol="..." />
+constexpr XMLElemFmt<8> POSITION_INFO_FMT(
+  "      ", "PositionInfo",
+  { "PositionType", "SectorName", "RadioName", "Prefix", "Suffix", "Frequency", "SectorID", "PositionSymbol" }
+);
+constexpr XMLElemFmt<8> POSITION_INFO_COMPACT_FMT(
+  "", "PositionInfo",
+  { "PositionType", "SectorName", "RadioName", "Prefix", "Suffix", "Frequency", "SectorID", "PositionSymbol" }
+);
+//indent of the <CommandAliases> and <Positions> block tags
+string static const BLOCK_INDENT = "    ";
+//separates the files/directories given in the VRC alias source argument
+#ifdef _WIN32
+char static const ALIAS_SRC_SEP = ';';
+#else
+char static const ALIAS_SRC_SEP = ':';
+#endif
 
 //////////////////////////////////////////////////////////////////////////////
 //GLOBAL VARIABLES
@@ -92,6 +775,8 @@ string thisProg_ = "";
 int status_ = GOOD;
 path tmpFldrPath_;
 Config cfg_;
+Options opts_;
+WorkerPool workerPool_;
 
 //////////////////////////////////////////////////////////////////////////////
 //FUNCTION DECLARATIONS
@@ -100,13 +785,27 @@ void prntHelp(ostream& out = cerr);
 void cleanNExit();
 void prntNExit(string const& msg, ostream& out = cerr);
 void chkArgs(int const& numArgs, char** const& argLst);
+//reads the -- switches into opts_ and removes them from argLst
+//  so the positional args keep their usual indexes
+void parseOpts(int& numArgs, char** argLst);
+//the facility files come in pairs, so an odd number of args after the
+//  aliases means the first of them is the VRCPofPath (argLst[POF_IDX])
+bool hasPofArg(int numArgs);
+//argLst index of the first original facility file
+int getFacilityIdx(int numArgs);
 
 string getTimeStr(); //YYMMDDhhmmss
 string getUpdateTimeStr(); //YYYY-MM-DDThh:mm:ss.*******-tz:tz
 int getPid();
+//true if stdin is an interactive terminal (so the user can be asked)
+bool isStdinTerminal();
 path genTmpFldr();
-void initCfg();
-void init(int const& numArgs, char** const& argLst);
+//loads cfg_ from opts_.cfgPath or, if none was given, DEFAULT_CFG (in
+//  the working directory)... if neither is there and canAsk is set, the
+//  user is asked for a config or to set up a new one
+//cfg_.isSet is left false if there is no config and no one to ask
+void initCfg(bool canAsk);
+void init(int& numArgs, char** argLst);
 
 //checks if filePath exists
 //if not, returns
@@ -118,6 +817,54 @@ void verifyFilePath(path& filePath);
 void delFilePath(path const& filePath);
 void verifyNDelFilePath(path& filePath);
 ifstream openInStrm(path const& filePath);
+//maps (or bulk reads) all of filePath into memory
+//  so it can be walked with string_views instead of getline
+InFileBuf openInBuf(path const& filePath);
+//same as openInBuf() but rtns false instead of exiting on failure
+//  so it is safe to call from worker threads
+bool readInBuf(path const& filePath, InFileBuf& inBuf);
+//pops the next line off the front of buf and stores it in line
+//  (without its \n or \r\n terminator)
+//rtns false once buf is empty
+bool popLine(string_view& buf, string_view& line);
+//pops the next sep separated field off the front of buf and stores
+//  it in field (without the sep)... field is empty once buf is
+//rtns false once buf is empty
+bool popField(string_view& buf, string_view& field, char sep);
+
+bool cpuHasSSE2();
+bool cpuHasAVX2();
+//finds every line of vrcAliasBuf that starts with a dot (.)
+//  and the first space of each of those lines, in a single pass
+//lineCnt is set to the number of \n found in vrcAliasBuf
+//uses the widest vector scanner the CPU supports
+vector<AliasLineIdx> scanAliasLines(string_view vrcAliasBuf, uint32_t& lineCnt);
+vector<AliasLineIdx> scanAliasLinesScalar(string_view vrcAliasBuf, uint32_t& lineCnt);
+#ifdef X86_SIMD
+vector<AliasLineIdx> scanAliasLinesSSE2(string_view vrcAliasBuf, uint32_t& lineCnt);
+vector<AliasLineIdx> scanAliasLinesAVX2(string_view vrcAliasBuf, uint32_t& lineCnt);
+#endif
+
+//rtns the offset of the first non-ASCII byte (>= 0x80) in buf
+//  or buf.size() if there is none
+//uses the widest vector scanner the CPU supports
+size_t findHighByte(string_view buf);
+size_t findHighByteScalar(string_view buf);
+#ifdef X86_SIMD
+size_t findHighByteSSE2(string_view buf);
+size_t findHighByteAVX2(string_view buf);
+#endif
+//true if buf[fromIdx...end] is well formed UTF-8
+bool isUTF8(string_view buf, size_t fromIdx = 0);
+//Windows-1252 to UTF-8... bytes before firstHighIdx are known to be ASCII
+//  and runs of ASCII are copied a vector block at a time
+string cp1252ToUTF8(string_view buf, size_t firstHighIdx);
+//input encoding stage for VRC alias and pof files
+//strips a UTF-8 byte order mark, leaves ASCII/UTF-8 input untouched and
+//  transcodes anything else from Windows-1252 (what Notepad and VRC write)
+//  into a new buffer... rtns the encoding that was found
+//UTF16 is rtnd (and inBuf left as is) for UTF-16 input, which is not supported
+TextEnc normalizeInBuf(InFileBuf& inBuf);
 
 //calls verifyFilePath() on filePath
 //then opens an ofstream in out|trunc mode
@@ -125,24 +872,245 @@ ofstream openOutStrm(path& filePath, bool const& force = false);
 ofstream openOutStrm(path&& filePath, bool const& force = false);
 
 //Escpaes ALL of the following characters found in str:
-//  & ' < " >
+//  & ' < "
+//  (> is left as is, XML allows it in attribute values)
 //If there are any of those characters that you do NOT want escaped...
-//  (like the < and > and the beginning and end of an XML entity)
+//  (like the < at the beginning of an XML element)
 //  do not include them in str
+//one scan measures the escaped length, then str is resized once and
+//  filled in from the back... linear no matter how much needs escaping
 void escapeXML(string& str);
-void escapeXML(string&& str);
-string cnvrtVRCaliasLine2XML(string const& aliasLine);
+//appends the escaped form of str to out, with no copy in between
+//  out grows once, by exactly the escaped length... and not at all
+//  (past its capacity) when it is reused for line after line
+void appendEscXML(string& out, string_view str);
+//appends one element of fmt to out, valLst holds one value per attribute
+//  a string value is escaped as it is appended (see appendEscXML()),
+//  an XMLRaw or a char value is appended as is
+//the fixed fragments are compile time constants, so an element is just
+//  a few memcpys plus the values
+template <size_t AttrCnt, typename... Vals>
+void appendXMLElem(string& out, XMLElemFmt<AttrCnt> const& fmt, Vals const&... valLst);
+void appendXMLVal(string& out, string_view val);
+void appendXMLVal(string& out, XMLRaw val);
+void appendXMLVal(string& out, char val);
+//measures what appendXMLElem() would append for the same args
+//  so a whole block can be sized before anything is written
+template <size_t AttrCnt, typename... Vals>
+size_t getXMLElemLen(XMLElemFmt<AttrCnt> const& fmt, Vals const&... valLst);
+size_t getXMLValLen(string_view val);
+size_t getXMLValLen(XMLRaw val);
+size_t getXMLValLen(char val);
+//same as appendXMLElem() with XMLRaw values, but the element is written
+//  at outPos (which needs room for getXMLElemLen() bytes)
+//rtns the end of the written element
+template <size_t AttrCnt, typename... Raws>
+char* writeXMLElem(char* outPos, XMLElemFmt<AttrCnt> const& fmt, Raws... valLst);
+//the element formats and the block tag indent of the output mode
+//  (indented, or not at all with --compact)
+XMLElemFmt<2> const& getCommandAliasFmt();
+XMLElemFmt<8> const& getPositionInfoFmt();
+string getBlockIndent();
+//the length str will have once it is escaped by escapeXML()
+size_t getEscXMLLen(string_view str);
+//rtns the offset of the first character escapeXML() has to escape
+//  or str.size() if there is none
+//uses the widest vector scanner the CPU supports
+size_t findXMLEscChar(string_view str);
+size_t findXMLEscCharScalar(string_view str);
+#ifdef X86_SIMD
+size_t findXMLEscCharSSE2(string_view str);
+size_t findXMLEscCharAVX2(string_view str);
+#endif
+//rtns the offset of the first < & or quote in str (what ends a run of
+//  XML text, or of an attribute value quoted with quote)
+//  or str.size() if there is none
+//uses the widest vector scanner the CPU supports
+size_t findXMLMarkupChar(string_view str, char quote);
+size_t findXMLMarkupCharScalar(string_view str, char quote);
+#ifdef X86_SIMD
+size_t findXMLMarkupCharSSE2(string_view str, char quote);
+size_t findXMLMarkupCharAVX2(string_view str, char quote);
+#endif
+//expands the VRC alias source argument into the list of files to load
+//the argument holds one or more files or directories separated by
+//  ALIAS_SRC_SEP... a directory stands for all of the regular files
+//  directly inside it (except .v2xalias caches), in filename order
+vector<path> parseAliasSrcArg(string const& aliasSrcArg);
+//maps and hashes all of the alias source files concurrently
+vector<AliasSrc> mapAliasSrcs(vector<path> const& srcPathLst);
+//runs the encoding stage on all of the alias sources
+//  and scans them for dot (.) lines concurrently
+void scanAliasSrcs(vector<AliasSrc>& srcLst);
+//fast (not cryptographic) 64 bit hash, 8 bytes at a time
+uint64_t hashBytes(string_view buf);
+//true if the VRC alias source argument is a stream instead of files...
+//  "-" for stdin, or a named pipe
+bool isAliasStrmArg(string const& aliasSrcArg);
+//opens the stream named by the VRC alias source argument for binary reads
+FILE* openAliasStrm(string const& aliasSrcArg);
+//the command (before the first space) and replacement (after it)
+//  of an alias line... a line without a space is used as both
+string_view getAliasCmd(string_view vrcAliasBuf, AliasLineIdx const& aliasLineIdx);
+string_view getAliasRplcmnt(string_view vrcAliasBuf, AliasLineIdx const& aliasLineIdx);
+//fills aliasTable with every alias of every source, in source order
+//  commands and replacements are escaped straight into the arena
+//  (in parallel chunks, with no temporaries per alias)
+//unless --no-lint, each replacement is linted while it is escaped
+void buildAliasTable(vector<AliasSrc> const& srcLst, AliasTable& aliasTable);
+//merges the aliases of all sources in aliasTable using a command index
+//  and removes the ones that lost from the table
+//when sources define the same command (case-insensitively) the LATER
+//  source wins... every definition from earlier sources is dropped and
+//  the command keeps the position of its definition in the later source
+//duplicates within a single source are reported with their line numbers
+//  and all kept, unless opts_.dropDups is set (then the last one wins)
+void mergeAliasTable(vector<AliasSrc> const& srcLst, AliasTable& aliasTable);
+//prints the totals of a merge and updates status_
+void reportAliasMerge(uint32_t dupCnt, uint32_t overrideCnt);
+//splits an alias replacement body into AliasToks (tokLst is cleared first)
+//  $name( starts a FUNC call that the matching ) closes (CALL_END),
+//  $name is a VAR, $1, $2... a PARAM and everything else is TEXT...
+//  parentheses outside of a call are just TEXT
+//strayCloseCnt gets the number of ) that close nothing (no call or ( open)
+//rtns the number of calls still open at the end of body
+uint32_t tokenizeAliasBody(string_view body, vector<AliasTok>& tokLst, uint32_t& strayCloseCnt);
+//the ALIAS_BUILTIN_LST entry for name (case-insensitive, without the '$')
+//  or nullptr if it is not a VRC variable or function
+AliasBuiltin const* findAliasBuiltin(string_view name);
+//tokenizes body and checks it against ALIAS_BUILTIN_LST for unknown
+//  variables/functions, functions used without (, unclosed calls and
+//  ) that close nothing
+//  ... an alias that only has a command (no body) is also a problem
+//appends one "Warning: ..." line per problem found to lintMsgs
+//  (srcName/lineNum locate the alias in them, srcName may be empty)
+//rtns the number of problems found
+uint32_t lintAliasBody(
+  string_view cmd, string_view body, bool hasBody,
+  string_view srcName, uint32_t lineNum,
+  vector<AliasTok>& tokLst, string& lintMsgs
+);
+//prints the total of the lint... and updates status_ if opts_.lintStrict
+void reportAliasLint(uint32_t lintCnt);
+//finds the strongly connected components of aliasGraph (Tarjan's
+//  algorithm, iterative so deep chains can not overflow the stack)
+//sccIdLst gets the component of every alias, numbered in the order they
+//  are completed... a component only refs itself or lower numbered ones
+//rtns the number of components
+uint32_t findAliasSCCs(AliasGraph const& aliasGraph, vector<uint32_t>& sccIdLst);
+//reports every cycle of aliases that run each other and the maximum
+//  expansion depth (how many aliases one command can run in a row)
+//rtns the number of cycles
+uint32_t reportAliasGraph(AliasTable const& aliasTable);
+//appends esc to str with the entities escapeXML() makes turned back
+//  into the characters they stand for
+void appendUnescXML(string& str, string_view esc);
+//reads a context file for AliasEngine... one name=value per line
+//  (variables by name, function results as name(arg)=value)
+//  blank lines and lines that start with ; are skipped
+ExpandCtx readExpandCtx(path const& ctxPath);
+//case-insensitive compare of alias commands (see CmdEq), rtns <0, 0 or >0
+int cmpCmd(string_view lhs, string_view rhs);
+//true if cmd starts with prefix (case-insensitive)
+bool cmdHasPrefix(string_view cmd, string_view prefix);
+//prints every command that is a prefix of other commands
+//  (.ctm shadows .ctmx while it is being typed)
+//rtns the number of shadowing commands
+size_t reportAliasShadows(CmdPrefixIdx const& prefixIdx);
+//the --query mode: loads the aliases named by aliasSrcArg, then prints
+//  the aliases that start with each prefix read from stdin to stdout
+//  (as command replacement lines, each query ends with a blank line)
+void runAliasQuery(string const& aliasSrcArg);
+//the --expand mode: loads the aliases named by aliasSrcArg, then
+//  prints the expansion of every command line read from stdin to stdout
+//  (a line with no alias is printed as is and reported)
+void runAliasExpand(string const& aliasSrcArg);
+//fills aliasTable from the .v2xalias cache if it matches srcLst,
+//  otherwise scans all sources, builds and merges the table
+//  and writes a new cache
+//either way the alias graph of the table is checked for cycles
+void loadAliasTable(vector<AliasSrc>& srcLst, AliasTable& aliasTable);
+//the .v2xalias cache that belongs to srcLst
+path getAliasCachePath(vector<AliasSrc> const& srcLst);
+//maps the cache at cachePath into aliasTable
+//rtns false (and leaves aliasTable empty) if there is no cache,
+//  or it is stale (srcLst or opts_ changed) or corrupt
+bool readAliasCache(
+  path const& cachePath, vector<AliasSrc> const& srcLst, AliasTable& aliasTable
+);
+//writes aliasTable to cachePath (thru a temp file and a rename)
+//  failure only warns, the cache is an optimization
+void writeAliasCache(
+  path const& cachePath, vector<AliasSrc> const& srcLst, AliasTable const& aliasTable
+);
+//appends the CommandAlias element of the line (no leading \n) to out
+void appendAliasLineXML(
+  string& out, string_view vrcAliasBuf, AliasLineIdx const& aliasLineIdx
+);
+//the length writeAliasRangeXML() writes for the same range
+size_t getAliasRangeXMLLen(
+  AliasTable const& aliasTable, size_t firstIdx, size_t lastIdx
+);
+//writes aliases [firstIdx...lastIdx) of the table at outPos, each
+//  preceded by a \n... rtns the end of what was written
+//reentrant... different ranges may be written on different threads at once
+char* writeAliasRangeXML(
+  char* outPos, AliasTable const& aliasTable, size_t firstIdx, size_t lastIdx
+);
+//ONLY cnvrts lines that start with a dot (.)
+//loads the AliasTable (see loadAliasTable()), then the block is built
+//  in two phases: the exact length of each chunk of aliases is measured,
+//  then every chunk is written straight into its place in the one
+//  allocation of the block (both phases in parallel)
+string cnvrtVRCalias2XML(vector<AliasSrc>& srcLst);
 //ONLY cnvrts lines that start with a dot (.)
-stringstream cnvrtVRCalias2XML(ifstream& vrcAliasFile);
-string cnvrtVRCpositionLine2XML(string const& aliasLine);
-//reads a line from the VRC pof file and rtns a corresponding Position
-//also calls escapeXML() for all string members of rtnd Position
-Position initPosition(string const& positionLine);
+//cnvrts each line as soon as it is read... the whole input is never held
+//  so there is no merge or duplicate detection for streamed aliases
+//  (the encoding stage is done one line at a time)
+//the block can not be measured ahead, so it grows as it is appended to
+string cnvrtVRCaliasStrm2XML(LineStrmReader& vrcAliasStrm);
+//appends the PositionInfo element of pos (no leading \n) to out
+//  the handle members are copied from strPool, already escaped
+//  (sectorName is escaped as it is appended)
+void appendPositionXML(string& out, Position const& pos, XMLStrPool const& strPool);
+//the length appendPositionXML() appends for pos
+size_t getPositionXMLLen(Position const& pos, XMLStrPool const& strPool);
+//parses a POF frequency in MHz (e.g. 124.350) into kHz above 100 MHz
+//  (e.g. 24350) with integer math, so it is exact
+//leading white space is skipped
+//rtns false (and leaves freq as is) if field does not start with a number
+//  or has a decimal past the kHz that is not 0 (it can not be exact)
+bool parseFreq(string_view field, int32_t& freq);
+//formats freq (in kHz) into freqBuf the way the frequency has always
+//  been written (to_string() of a float): -?digits.000000
+//rtns the formatted text (a view into freqBuf)
+string_view fmtFreq(int32_t freq, array<char, FREQ_STR_LEN>& freqBuf);
+//splits a line from the VRC pof file at its colons (:) and rtns the
+//  corresponding Position... the repeating fields are interned into
+//  strPool, so only a string not seen before is escaped and stored
+//positionLine has to outlive strPool (the pool keys are views into it)
+//SectorName:RadioName:Freq:SectorID:PositionSymbol:Prefix:Suffix:...
+Position initPosition(string_view positionLine, XMLStrPool& strPool);
 //cnvrts ALL lines that do NOT start with a semi-colon (;)
-stringstream cnvrtVRCpof2XML(ifstream& vrcPofFile);
+//  (blank lines are skipped as well)
+//a frequency parseFreq() rejects is warned about (with the sector name
+//  and line) and updates status_, the position is still written
+//each line is parsed once into a Position, then the block is measured
+//  and written from the pool, so it is one exact allocation
+string cnvrtVRCpof2XML(string_view vrcPofBuf);
+//calls taskFn(0) ... taskFn(taskCnt - 1) from the pool of worker threads
+//  (workerPool_, one per hardware thread counting this one)
+//  and rtns once all calls are done
+void runTasks(size_t taskCnt, function<void(size_t)> const& taskFn);
+//splits buf into at most chunkCnt chunks of about equal size
+//every chunk but the last ends just after a \n
+vector<string_view> splitAtLines(string_view buf, size_t chunkCnt);
 void gzipFile(path const& filePath);
-void gzipStrm(stringstream& in, path& filePath);
+void gzipStrm(istream& in, path& filePath);
 stringstream ungzip2Strm(path const& filePath);
+//exits (see prntNExit()) if the spliced facility file is not well-formed
+//  XML (see XMLValidator), so a bad one is never written
+void validateFacilityXML(SpanLst const& facilityDoc, path const& facilityFilePath);
 
 // --- --- --- DEPRACATED --- --- --- //
 //Reads facility files in argLst[3+2n] where n is an integer.
@@ -157,46 +1125,77 @@ void addCmds2Facilities(
   string const& cmdBlock, int const& numArgs, char** const& argLst
 );
 
-//Reads facility files in argLst[3+2n] where n is an integer.
+//Reads facility files in argLst[getFacilityIdx()+2n] where n is an integer.
 //  Reads to end of argLst
 //Adds cmdBlock and posBlock to the appropriate location
 //  and outputs to new facility files
-//Pre-condition: Original faciality file names are define in argLst[3+2n]
-//Pre-condition: New facility file names are defined in argLst[3+2n+1]
+//An empty posBlock (no VRCPofPath given) keeps the Positions block of
+//  each facility file as it is
+//The blocks are taken by value, pass them with move() so they are
+//  never copied... nor is the rest of the facility file, the new file is
+//  a SpanLst of the blocks and the retained parts of the original
+//  that is read straight into the compressor
+//Pre-condition: Original faciality file names are define in argLst[getFacilityIdx()+2n]
+//Pre-condition: New facility file names are defined in argLst[getFacilityIdx()+2n+1]
 //  Each new name defines the output file of the input name sequentially
 //  before it in argLst
 //CAUTION: If the output file name is the same as the input name,
 //  this will automatically clobber the original file
 void updateFacilityFiles(
-  string const& cmdBlock, string const& posBlock,
+  string cmdBlock, string posBlock,
   int const& numArgs, char** const& argLst
 );
 
 //////////////////////////////////////////////////////////////////////////////
 //MAIN FUNCTION
 //////////////////////////////////////////////////////////////////////////////
+//the test driver (Alias2FacilityTests) includes this file and brings
+//  its own main
+#ifndef ALIAS2FACILITY_NO_MAIN
 int main(int numArgs, char* argLst[]) {
   init(numArgs, argLst);
 
-  path vrcAliasPath(argLst[1]);
-  ifstream vrcAliasFile = openInStrm(vrcAliasPath);
-  stringstream commAliasesXML = cnvrtVRCalias2XML(vrcAliasFile);
+  if (!opts_.expandCtxPath.empty()) {
+    runAliasExpand(argLst[1]);
+    cleanNExit();
+  }
+  if (opts_.query) {
+    runAliasQuery(argLst[1]);
+    cleanNExit();
+  }
+
+  string commAliasesXML;
+  if (isAliasStrmArg(argLst[1])) {
+    LineStrmReader vrcAliasStrm(openAliasStrm(argLst[1]), STRM_BUF_LEN);
+    commAliasesXML = cnvrtVRCaliasStrm2XML(vrcAliasStrm);
+  }
+  else {
+    vector<AliasSrc> vrcAliasSrcLst = mapAliasSrcs(parseAliasSrcArg(argLst[1]));
+    commAliasesXML = cnvrtVRCalias2XML(vrcAliasSrcLst);
+  }//end if alias stream ... else
   
-  /*
-  path vrcPofPath(argLst[2]);
-  ifstream vrcPofFile = openInStrm(vrcPofPath);
-  stringstream positionsXML = cnvrtVRCpof2XML(vrcPofFile);
-  */
-  stringstream positionsXML;
+  //without a POF (or a config to classify its positions with) the
+  //  Positions blocks are kept as they are
+  string positionsXML;
+  if (hasPofArg(numArgs) && cfg_.isSet) {
+    path vrcPofPath(argLst[POF_IDX]);
+    InFileBuf vrcPofFile = openInBuf(vrcPofPath);
+    if (normalizeInBuf(vrcPofFile) == TextEnc::UTF16) {
+      status_ += INPUT_ENCODING;
+      prntNExit("UTF-16 input is not supported, save as ANSI or UTF-8: "s + vrcPofPath.string());
+    }
+    positionsXML = cnvrtVRCpof2XML(vrcPofFile.view());
+  }//end if POF given
 
   cout << endl << "This will take a moment, please wait..." << endl;
   updateFacilityFiles(
-    commAliasesXML.str(), positionsXML.str(),
+    move(commAliasesXML), move(positionsXML),
     numArgs, argLst
   );
 
   cleanNExit();
 }//end main
+#endif
 //////////////////////////////////////////////////////////////////////////////
 //END MAIN FUNCTION
 //////////////////////////////////////////////////////////////////////////////
@@ -210,9 +1209,42 @@ void prntHelp(ostream& out) {
   //key: [] = required arg
   //     <> = optional arg
   //     {} = arg groups
-  //usage: prog [VRCAliasPath] [VRCPofPath] [{originalFacilityFilePath newFacilityFilePath}...]
-  //Automatically looks for default.v2xcfg file in install directory.
-  ///  Uses that if found, otherwise prompts for location of .v2xcfg
+  //usage: prog <--drop-dups> <--no-cache> <--no-lint> <--lint-strict> <--compact> [VRCAliasPath<;VRCAliasPath...>] <VRCPofPath> [{originalFacilityFilePath newFacilityFilePath}...]
+  //  VRCPofPath may be left out, then the Positions block of each
+  //    facility file is kept as it is (only the aliases are replaced)
+  //    ...the facility files come in pairs, so the POF is there if
+  //    an odd number of paths follow VRCAliasPath
+  //  each VRCAliasPath may be a file or a directory of alias files
+  //  (separated by : instead of ; on *nix)
+  //  if more than one defines the same command, the last one wins
+  //  VRCAliasPath may instead be - (stdin) or a named pipe, which is
+  //    converted as it is read (no merging or duplicate detection)
+  //  --drop-dups: if one file defines the same command more than once,
+  //    only keep the last definition (otherwise all are kept and reported)
+  //  --no-cache: do not use or write the VRCAliasPath.v2xalias cache
+  //    (by default it is rebuilt whenever the alias files change)
+  //  --no-lint: do not warn about unknown $variables/$functions,
+  //    unclosed $function( calls and aliases without a replacement
+  //  --lint-strict: exit with a nonzero status if the lint warned
+  //    (by default its warnings do not change the exit status)
+  //  --compact: write the new CommandAliases and Positions blocks
+  //    without indentation (the rest of the facility file is kept as is)
+  //  --cfg=CfgPath: the .v2xcfg with the "In Facility" and "Adjacent"
+  //    sector IDs the positions are classified with (only with a POF)
+  //    without it default.v2xcfg in the working directory is used,
+  //    if that is not there either it is asked for (only if stdin is a
+  //    terminal)... with no config at all the Positions blocks are
+  //    kept as they are rather than marking every position "Other"
+  //or:    prog <--drop-dups> <--no-cache> --expand=CtxPath [VRCAliasPath<;VRCAliasPath...>]
+  //  prints the expansion of each command line read from stdin
+  //  (e.g. .ctm N123AB) against the simulated client state in CtxPath
+  //  CtxPath has one name=value per line, e.g. callsign=N123AB, alt=5000
+  //    or freq(ZNY_CTR)=125.325 for the result of $freq(ZNY_CTR)
+  //or:    prog <--drop-dups> <--no-cache> <--shadows> --query [VRCAliasPath<;VRCAliasPath...>]
+  //  prints the aliases whose command starts with each prefix read
+  //  from stdin (e.g. .ctm), each list ends with a blank line
+  //  --shadows: (any mode) also report the commands that are a prefix
+  //    of other commands, e.g. .ctm and .ctmx
 }//end prntHelp
 
 //----------------------------------------------------------------------------
@@ -240,15 +1272,62 @@ void prntNExit(string const& msg, ostream& out) {
 
 //----------------------------------------------------------------------------
 void chkArgs(int const& numArgs, char** const& argLst) {
-  //if (numArgs >= 5) //for pof
+  if (!opts_.expandCtxPath.empty() && opts_.query) {
+    status_ += NUM_ARGS;
+    prntHelp();
+    prntNExit("--expand and --query can not be used together");
+  }
+  //the aliases and at least one pair of facility files (the POF is optional)
   if (numArgs >= 4)
     return;
+  //--expand and --query only need the aliases
+  if ((!opts_.expandCtxPath.empty() || opts_.query) && numArgs >= 2)
+    return;
 
   status_ += NUM_ARGS;
   prntHelp();
   prntNExit("Incorrect number of arguments");
 }//end chkArgs
 
+//----------------------------------------------------------------------------
+void parseOpts(int& numArgs, char** argLst) {
+  int keptCnt = 1;
+  //LOOP THRU ARGS (SKIPPING PROG NAME)
+  for (int argIdx = 1; argIdx < numArgs; ++argIdx) {
+    string_view arg = argLst[argIdx];
+    if (arg.substr(0, 2) != "--") {
+      argLst[keptCnt++] = argLst[argIdx];
+      continue; //!!!GO TO NEXT ARG!!!//
+    }
+
+    if (arg == "--drop-dups") opts_.dropDups = true;
+    else if (arg == "--no-cache") opts_.useCache = false;
+    else if (arg == "--no-lint") opts_.lint = false;
+    else if (arg == "--lint-strict") opts_.lintStrict = true;
+    else if (arg.substr(0, 9) == "--expand=" && arg.size() > 9) opts_.expandCtxPath = arg.substr(9);
+    else if (arg == "--query") opts_.query = true;
+    else if (arg == "--shadows") opts_.shadows = true;
+    else if (arg == "--compact") opts_.compact = true;
+    else if (arg.substr(0, 6) == "--cfg=" && arg.size() > 6) opts_.cfgPath = arg.substr(6);
+    else {
+      status_ += NUM_ARGS;
+      prntHelp();
+      prntNExit("Unknown option: "s + argLst[argIdx]);
+    }
+  }//END LOOP THRU ARGS
+  numArgs = keptCnt;
+}//end parseOpts
+
+//----------------------------------------------------------------------------
+bool hasPofArg(int numArgs) {
+  return (numArgs - FACILITY_IDX) % 2 == 1;
+}//end hasPofArg
+
+//----------------------------------------------------------------------------
+int getFacilityIdx(int numArgs) {
+  return hasPofArg(numArgs) ? POF_IDX + 1 : FACILITY_IDX;
+}//end getFacilityIdx
+
 //----------------------------------------------------------------------------
 string getTimeStr() {
   time_t currTime = sys_clock::to_time_t(sys_clock::now());
@@ -313,6 +1392,15 @@ int getPid() {
 #endif
 }//end getPid
 
+//----------------------------------------------------------------------------
+bool isStdinTerminal() {
+#ifdef _WIN32
+  return _isatty(_fileno(stdin)) != 0;
+#else
+  return isatty(fileno(stdin)) != 0;
+#endif
+}//end isStdinTerminal
+
 //----------------------------------------------------------------------------
 path genTmpFldr() {
   string timeStr = getTimeStr();
@@ -341,17 +1429,89 @@ void readNPopulateCfg(ifstream& cfgFileStrm) {
   sectorLstStrm = stringstream(sectorLstLine);
   while (sectorLstStrm >> sectorID)
     cfg_.adjacentLst.insert(sectorID);
+
+  cfg_.buildSectorClassTbl();
 }//end readNPopulateCfg
 
+//----------------------------------------------------------------------------
+//sectorID has to be MAX_PACKED_SECTOR_ID_LEN chars or less
+//  the length is part of the key, so "A" and "A\0" do not collide
+static inline uint32_t packSectorID(string_view sectorID) {
+  uint32_t key = static_cast<uint32_t>(sectorID.size()) << 24;
+  for (size_t chrIdx = 0; chrIdx < sectorID.size(); ++chrIdx)
+    key |= static_cast<uint32_t>(static_cast<unsigned char>(sectorID[chrIdx])) << (8 * chrIdx);
+  return key;
+}//end packSectorID
+
+//----------------------------------------------------------------------------
+//the home slot of a packed sector ID (multiplicative hash)
+static inline uint32_t getSectorSlotIdx(uint32_t key, uint32_t slotMask) {
+  return ((key * 0x9E3779B1u) >> 16) & slotMask;
+}//end getSectorSlotIdx
+
+//----------------------------------------------------------------------------
+void Config::buildSectorClassTbl() {
+  //keep the load factor at or under 1/2
+  uint32_t slotCnt = 16;
+  while (slotCnt < 2 * (inFacilityLst.size() + adjacentLst.size())) slotCnt *= 2;
+  sectorClassTbl.assign(slotCnt, 0);
+  sectorClassMask = slotCnt - 1;
+
+  auto addSectorIDs = [this](unordered_set<string> const& sectorLst, SectorClass sectorClass) {
+    //LOOP THRU SECTOR IDS
+    for (string const& sectorID : sectorLst) {
+      if (sectorID.size() > MAX_PACKED_SECTOR_ID_LEN) continue; //!!!GO TO NEXT SECTOR ID!!!//
+      uint32_t key = packSectorID(sectorID);
+      uint32_t slotIdx = getSectorSlotIdx(key, sectorClassMask);
+      //an ID in both lists keeps the slot it has... it just gets the new class
+      while (sectorClassTbl[slotIdx] != 0 && (sectorClassTbl[slotIdx] & SECTOR_KEY_MASK) != key)
+        slotIdx = (slotIdx + 1) & sectorClassMask;
+      sectorClassTbl[slotIdx] = key | (static_cast<uint32_t>(sectorClass) << SECTOR_CLASS_SHIFT);
+    }//END LOOP THRU SECTOR IDS
+  };
+  //Adjacent last, so it wins over In Facility
+  addSectorIDs(inFacilityLst, SectorClass::IN_FACILITY);
+  addSectorIDs(adjacentLst, SectorClass::ADJACENT);
+}//end Config::buildSectorClassTbl
+
+//----------------------------------------------------------------------------
+SectorClass Config::classify(string_view sectorID) const {
+  if (sectorID.size() > MAX_PACKED_SECTOR_ID_LEN) {
+    string sectorIDKey(sectorID);
+    if (adjacentLst.count(sectorIDKey)) return SectorClass::ADJACENT;//!!! EXIT FUNCTION HERE !!!//
+    if (inFacilityLst.count(sectorIDKey)) return SectorClass::IN_FACILITY;//!!! EXIT FUNCTION HERE !!!//
+    return SectorClass::OTHER;//!!! EXIT FUNCTION HERE !!!//
+  }
+  //no cfg was loaded
+  if (sectorClassTbl.empty()) return SectorClass::OTHER;//!!! EXIT FUNCTION HERE !!!//
+
+  uint32_t key = packSectorID(sectorID);
+  uint32_t slotIdx = getSectorSlotIdx(key, sectorClassMask);
+  //LOOP THRU PROBE SEQUENCE
+  for (uint32_t slot; (slot = sectorClassTbl[slotIdx]) != 0; slotIdx = (slotIdx + 1) & sectorClassMask) {
+    if ((slot & SECTOR_KEY_MASK) == key) return static_cast<SectorClass>(slot >> SECTOR_CLASS_SHIFT);//!!! EXIT FUNCTION HERE !!!//
+  }//END LOOP THRU PROBE SEQUENCE
+  return SectorClass::OTHER;
+}//end Config::classify
+
 //write and reads "In Facility" list first,
 //  then "Adjacent" list
-void initCfg() {
+void initCfg(bool canAsk) {
+  //a config named on the command line has to be there
+  if (!opts_.cfgPath.empty()) {
+    ifstream cfgFileStrm = openInStrm(opts_.cfgPath);
+    readNPopulateCfg(cfgFileStrm);
+    cfg_.isSet = true;
+    return;//!!! EXIT FUNCTION HERE !!!//
+  }
   path cfgPath(DEFAULT_CFG);
   if (filesystem::exists(cfgPath)) {
     ifstream cfgFileStrm = openInStrm(cfgPath);
     readNPopulateCfg(cfgFileStrm);
+    cfg_.isSet = true;
     return;//!!! EXIT FUNCTION HERE !!!//
   }
+  if (!canAsk) return;//!!! EXIT FUNCTION HERE !!!//
   
   string response;
   //WHILE INPUT INVALID
@@ -369,6 +1529,7 @@ void initCfg() {
     cfgPath = cfgFileName;
     ifstream cfgFileStrm = openInStrm(cfgPath);
     readNPopulateCfg(cfgFileStrm);
+    cfg_.isSet = true;
     return;//!!! EXIT FUNCTION HERE !!!//
   }
   response.clear();
@@ -384,6 +1545,7 @@ void initCfg() {
   }//END WHILE INPUT INVALID
 
   //ask user to continue without cfg or create new one
+  cfg_.isSet = true;
   if (toupper(response[0]) != 'Y') {
     cout << "Continuing without \"Adjacent\" or \"In Facility\" "
           << "position config..." << endl;
@@ -406,6 +1568,7 @@ void initCfg() {
   input.clear();
   while (inputStrm >> input)
     cfg_.adjacentLst.insert(input);
+  cfg_.buildSectorClassTbl();
 
   //create new cfg file
   cout << "Enter the path where you would like to save the new config file. " 
@@ -422,17 +1585,26 @@ void initCfg() {
 }//end initCfg
 
 //----------------------------------------------------------------------------
-void init(int const& numArgs, char** const& argLst) {
+void init(int& numArgs, char** argLst) {
   thisProg_ = argLst[0];
   path tmp(thisProg_);
   thisProg_ = tmp.filename().string();
 
+  parseOpts(numArgs, argLst);
   chkArgs(numArgs, argLst);
 
   //tmpFldrPath_ = genTmpFldr();
   cerr << "tmpFldrPath: " << tmpFldrPath_.string() << endl;
 
-  //initCfg();
+  //the config only classifies the positions, so it is only needed with
+  //  a POF... the user can not be asked if stdin is not a terminal or
+  //  holds the aliases
+  if (hasPofArg(numArgs) && opts_.expandCtxPath.empty() && !opts_.query) {
+    initCfg(isStdinTerminal() && !isAliasStrmArg(argLst[1]));
+    if (!cfg_.isSet)
+      cerr << "Warning: no config found (" << DEFAULT_CFG << " or --cfg=CfgPath)... "
+        << "the Positions blocks are kept as they are" << endl;
+  }
 }//end init
 
 //----------------------------------------------------------------------------
@@ -446,7 +1618,11 @@ void verifyFilePath(path& filePath) {
       << "  (2) Enter a new file path" << endl
       << "  (3) Exit" << endl
       << "Type selection and press [enter]: ";
-    getline(cin, select);
+    //stdin may be gone already (e.g. it held the VRC aliases)
+    if (!getline(cin, select)) {
+      status_ += OPEN_FILE_FAILURE;
+      prntNExit("No answer available... not clobbering: "s + filePath.string());
+    }
 
     if (select == "1") break;
     if (select == "2") {
@@ -494,211 +1670,2900 @@ ifstream openInStrm(path const& filePath) {
 }//end openInStrm
 
 //----------------------------------------------------------------------------
-ofstream openOutStrm(path& filePath, bool const& force) {
-  if(!force) verifyFilePath(filePath);
-
-  ofstream outFileStrm(filePath, ios_base::out|ios_base::trunc);
-  if (!outFileStrm) {
-    status_ += OPEN_FILE_FAILURE;
-    prntNExit("Unable to open output file path: "s + filePath.string());
-  }//end if
-
-  return outFileStrm;
-}//end openOutStrm(path&)
+InFileBuf::InFileBuf(InFileBuf&& other) noexcept
+  : data_(other.data_), size_(other.size_),
+    bulkBuf_(move(other.bulkBuf_)), mapAddr_(other.mapAddr_), mapLen_(other.mapLen_)
+#ifdef _WIN32
+  , mapHndl_(other.mapHndl_)
+#endif
+{
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.mapAddr_ = nullptr;
+  other.mapLen_ = 0;
+#ifdef _WIN32
+  other.mapHndl_ = NULL;
+#endif
+}//end InFileBuf(InFileBuf&&)
 
 //----------------------------------------------------------------------------
-ofstream openOutStrm(path&& filePath, bool const& force) {
-  if (!force) verifyFilePath(filePath);
+InFileBuf& InFileBuf::operator=(InFileBuf&& other) noexcept {
+  if (this == &other) return *this;
 
-  ofstream outFileStrm(filePath, ios_base::out | ios_base::trunc);
-  if (!outFileStrm) {
-    status_ += OPEN_FILE_FAILURE;
-    prntNExit("Unable to open output file path: "s + filePath.string());
-  }//end if
+  //releases whatever this used to hold when it goes out of scope
+  InFileBuf old(move(*this));
+  data_ = other.data_;
+  size_ = other.size_;
+  bulkBuf_ = move(other.bulkBuf_);
+  mapAddr_ = other.mapAddr_;
+  mapLen_ = other.mapLen_;
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.mapAddr_ = nullptr;
+  other.mapLen_ = 0;
+#ifdef _WIN32
+  mapHndl_ = other.mapHndl_;
+  other.mapHndl_ = NULL;
+#endif
 
-  return outFileStrm;
-}//end openOutStrm(path&&)
+  return *this;
+}//end InFileBuf::operator=
 
 //----------------------------------------------------------------------------
-void escapeXML(string& str) {
-  char searchTermLst[4] = { '&', '"', '\'', '<' };
-  string replacementLst[4] = { "&amp;", "&quot;", "&apos;", "&lt;" };
-  char term = '\0';
-  string rplcmnt;
-  size_t escapePos = -1;
-  //LOOP THRU INVALID terms
-  for (int termIdx = 0; termIdx < 4; ++termIdx) {
-    term = searchTermLst[termIdx];
-    rplcmnt = replacementLst[termIdx];
-    escapePos = str.find(term);
-    //LOOP WHILE AN INSTNACE OF term IS STILL IN str
-    while (escapePos != string::npos) {
-      str.replace(escapePos, 1, rplcmnt);
-      escapePos += (rplcmnt.length() - 1);
-      escapePos = str.find(term, escapePos);
-    }//END LOOP THRU str FOR term
-  }//END LOOP THRU INVALID CHARS
-}//end escapeXML
+InFileBuf::~InFileBuf() {
+  if (mapAddr_ == nullptr) return;
+#ifdef _WIN32
+  UnmapViewOfFile(mapAddr_);
+  CloseHandle(mapHndl_);
+#else
+  munmap(mapAddr_, mapLen_);
+#endif
+  mapAddr_ = nullptr;
+}//end ~InFileBuf
 
 //----------------------------------------------------------------------------
-void escapeXML(string&& str) {
-  char searchTermLst[4] = { '&', '"', '\'', '<'};
-  string replacementLst[4] = { "&amp;", "&quot;", "&apos;", "&lt;" };
-  char term = '\0';
-  string rplcmnt;
-  size_t escapePos = -1;
-  //LOOP THRU INVALID terms
-  for (int termIdx = 0; termIdx < 4; ++termIdx) {
-    term = searchTermLst[termIdx];
-    rplcmnt = replacementLst[termIdx];
-    escapePos = str.find(term);
-    //LOOP WHILE AN INSTNACE OF term IS STILL IN str
-    while (escapePos != string::npos) {
-      str.replace(escapePos, 1, rplcmnt);
-      escapePos += (rplcmnt.length()-1);
-      escapePos = str.find(term, escapePos);
-    }//END LOOP THRU str FOR term
-  }//END LOOP THRU INVALID CHARS
-}//end escapeXML
+void SpanLst::push(string_view span) {
+  len += span.size();
+  if (!spanLst.empty() && spanLst.back().data() + spanLst.back().size() == span.data())
+    spanLst.back() = string_view(spanLst.back().data(), spanLst.back().size() + span.size());
+  else
+    spanLst.push_back(span);
+}//end SpanLst::push
 
 //----------------------------------------------------------------------------
-string cnvrtVRCaliasLine2XML(string const& aliasLine) {
-  int static cmdNameLen;
-  cmdNameLen = aliasLine.find(' ');
-  int static rplcmntIdx;
-  rplcmntIdx = cmdNameLen + 1;
+SpanStrmBuf::int_type SpanStrmBuf::underflow() {
+  spanPos += egptr() - eback();
+  //LOOP THRU SPANS UNTIL ONE HAS SOMETHING LEFT TO READ
+  while (nextSpanIdx < src.spanLst.size()) {
+    string_view span = src.spanLst[nextSpanIdx++];
+    if (span.empty()) continue; //!!!GO TO NEXT SPAN!!!//
+    //the get area is only ever read from
+    char* spanBuf = const_cast<char*>(span.data());
+    setg(spanBuf, spanBuf, spanBuf + span.size());
+    return traits_type::to_int_type(*gptr());
+  }//END LOOP THRU SPANS
 
-  string cmdName = aliasLine.substr(0, cmdNameLen);
-  string rplcmnt = aliasLine.substr(rplcmntIdx);
+  setg(nullptr, nullptr, nullptr);
+  return traits_type::eof();
+}//end SpanStrmBuf::underflow
 
-  escapeXML(cmdName);
-  escapeXML(rplcmnt);
+//----------------------------------------------------------------------------
+SpanStrmBuf::pos_type SpanStrmBuf::seekoff(
+  off_type off, ios_base::seekdir dir, ios_base::openmode which
+) {
+  off_type basePos = 0;
+  if (dir == ios_base::cur) basePos = static_cast<off_type>(spanPos + (gptr() - eback()));
+  else if (dir == ios_base::end) basePos = static_cast<off_type>(src.len);
+  off_type newPos = basePos + off;
+  if (!(which & ios_base::in) || newPos < 0 || newPos > static_cast<off_type>(src.len))
+    return pos_type(off_type(-1));//!!! EXIT FUNCTION HERE !!!//
 
-  return "      <CommandAlias Command=\"" + cmdName + "\" ReplaceWith=\"" + rplcmnt + "\" />";
-}//end cnvrtVRCaliasLine2XML
+  //the get area is reloaded by underflow() from the span that holds newPos
+  size_t spanStart = 0;
+  nextSpanIdx = 0;
+  while (nextSpanIdx < src.spanLst.size()
+    && spanStart + src.spanLst[nextSpanIdx].size() <= static_cast<size_t>(newPos))
+    spanStart += src.spanLst[nextSpanIdx++].size();
+  spanPos = spanStart;
+  if (nextSpanIdx < src.spanLst.size()) {
+    char* spanBuf = const_cast<char*>(src.spanLst[nextSpanIdx].data());
+    setg(spanBuf, spanBuf + (newPos - spanStart), spanBuf + src.spanLst[nextSpanIdx].size());
+    ++nextSpanIdx;
+  }
+  else setg(nullptr, nullptr, nullptr);
 
-//----------------------------------------------------------------------------
-stringstream cnvrtVRCalias2XML(ifstream& vrcAliasFile) {
-  string aliasLine;
-  stringstream cmdAliasesXML;
-  cmdAliasesXML << "    <CommandAliases>";
-  //LOOP THRU LINES OF VRC ALIAS FILE
-  while (getline(vrcAliasFile, aliasLine)) {
-    if (aliasLine[0] != '.') continue; //!!!GO TO NEXT LINE!!!//
-    cmdAliasesXML << endl << cnvrtVRCaliasLine2XML(aliasLine);
-  }//END LOOP THRU VRC ALIAS FILE
-  cmdAliasesXML << endl << "    </CommandAliases>";
-  //<CommandAliasesLastImported>2021-03-24T19:26:55.1456232-04:00</CommandAliasesLastImported>
-  cmdAliasesXML << endl << "    <CommandAliasesLastImported>"+getUpdateTimeStr()+"</CommandAliasesLastImported>";
+  return pos_type(newPos);
+}//end SpanStrmBuf::seekoff
 
-  return cmdAliasesXML;
-}//end cnvrtVRCalias2XML
+//----------------------------------------------------------------------------
+SpanStrmBuf::pos_type SpanStrmBuf::seekpos(pos_type pos, ios_base::openmode which) {
+  return seekoff(off_type(pos), ios_base::beg, which);
+}//end SpanStrmBuf::seekpos
 
 //----------------------------------------------------------------------------
-Position initPosition(string const& positionLine) {
-  Position pos;
-  stringstream posLineStrm(positionLine);
-  getline(posLineStrm, pos.sectorName, ':');
-  getline(posLineStrm, pos.radioName, ':');
-  posLineStrm >> pos.freq;
-  posLineStrm.ignore(1, ':');
-  getline(posLineStrm, pos.sectorID, ':');
-  posLineStrm >> pos.posSym;
-  posLineStrm.ignore(1, ':');
-  getline(posLineStrm, pos.prefix, ':');
-  getline(posLineStrm, pos.suffix, ':');
-
-  pos.freq = (pos.freq - 100) * 1000;
-  escapeXML(pos.sectorName);
-  escapeXML(pos.radioName);
-  escapeXML(pos.prefix);
-  escapeXML(pos.suffix);
-  escapeXML(pos.sectorID);
-
-  if (cfg_.adjacentLst.count(pos.sectorID))
-    pos.positionType = "Adjacent";
-  else if(cfg_.inFacilityLst.count(pos.sectorID))
-    pos.positionType = "InFacility";
-  else
-    pos.positionType = "Other";
+static inline bool isXMLSpace(unsigned char chr) {
+  return chr == ' ' || chr == '\n' || chr == '\r' || chr == '\t';
+}//end isXMLSpace
 
-  return pos;
-}//end initPosition
+//----------------------------------------------------------------------------
+static inline bool isXMLNameStart(unsigned char chr) {
+  return XML_NAME_CHAR_LST[chr] == XML_NAME_START;
+}//end isXMLNameStart
 
 //----------------------------------------------------------------------------
-string cnvrtVRCpositionLine2XML(string const& positionLine) {
-  Position pos = initPosition(positionLine);
-  
-  return "      <PositionInfo PositionType=\""s+pos.positionType+"\" SectorName=\""+pos.sectorName+"\" RadioName=\""+pos.radioName+"\" Prefix=\""+pos.prefix+"\" Suffix=\""+pos.suffix+"\" Frequency=\""+to_string(pos.freq)+"\" SectorID=\""+pos.sectorID+"\" PositionSymbol=\""+pos.posSym+"\" />";
-}//end cnvrtVRCpositionLine2XML
+static inline bool isXMLNameChar(unsigned char chr) {
+  return XML_NAME_CHAR_LST[chr] != 0;
+}//end isXMLNameChar
 
 //----------------------------------------------------------------------------
-stringstream cnvrtVRCpof2XML(ifstream& vrcPofFile) {
-  string positionLine;
-  stringstream positionsXML;
-  positionsXML << "    <Positions>";
-  //LOOP THRU LINES OF VRC ALIAS FILE
-  while (getline(vrcPofFile, positionLine)) {
-    if (positionLine[0] == ';') continue; //!!!GO TO NEXT LINE!!!//
-    positionsXML << endl << cnvrtVRCpositionLine2XML(positionLine);
-  }//END LOOP THRU VRC ALIAS FILE
-  positionsXML << endl << "    </Positions>";
+//name is what is between the & and the ;
+//a character reference (&#...;) has to be to a character XML allows
+//  (so not &#0;, a surrogate or &#xFFFE;)
+static bool isXMLEntity(string_view name) {
+  if (name == "amp" || name == "lt" || name == "gt" || name == "quot" || name == "apos")
+    return true;//!!! EXIT FUNCTION HERE !!!//
+  if (name.size() < 2 || name[0] != '#') return false;//!!! EXIT FUNCTION HERE !!!//
 
-  return positionsXML;
-}//end cnvrtVRCpof2XML
+  bool isHex = (name[1] == 'x');
+  name.remove_prefix(isHex ? 2 : 1);
+  if (name.empty()) return false;//!!! EXIT FUNCTION HERE !!!//
+  //at most 7 digits (see maxEntityLen), so it can not overflow
+  uint32_t codePt = 0;
+  for (char chr : name) {
+    unsigned char digit = static_cast<unsigned char>(chr);
+    if (!(isHex ? isxdigit(digit) : isdigit(digit))) return false;//!!! EXIT FUNCTION HERE !!!//
+    codePt = codePt * (isHex ? 16 : 10) + (isdigit(digit) ? digit - '0' : (digit | 0x20) - 'a' + 10);
+  }
+  return codePt == 0x9 || codePt == 0xA || codePt == 0xD
+    || (codePt >= 0x20 && codePt <= 0xD7FF) || (codePt >= 0xE000 && codePt <= 0xFFFD)
+    || (codePt >= 0x10000 && codePt <= 0x10FFFF);
+}//end isXMLEntity
 
 //----------------------------------------------------------------------------
-void gzipFile(path const& filePath){
-  //try compress
-  try {
-    BitCompressor bit7zCompressor(Bit7zLibrary(), ::bit7z::BitFormat::GZip);
+bool XMLValidator::feed(string_view span) {
+  if (!errMsg.empty()) return false;//!!! EXIT FUNCTION HERE !!!//
 
-    path newGZipFacilityPath = filePath.wstring() + L".gz";
-    verifyNDelFilePath(newGZipFacilityPath);
+  //&#x10FFFF; is the longest entity there can be
+  size_t const maxEntityLen = 8;
+  auto fail = [&](size_t idx, string const& msg) {
+    errPos = docPos + idx;
+    errMsg = msg;
+    return false;
+  };
+  auto closeTag = [&](size_t idx) {
+    if (openTagIdxLst.empty()) return fail(idx, "</" + markup + "> has no start tag");
+    string_view openTag = string_view(openTagArena).substr(openTagIdxLst.back());
+    if (openTag != markup)
+      return fail(idx, "</" + markup + "> does not close <" + string(openTag) + ">");
+    openTagArena.resize(openTagIdxLst.back());
+    openTagIdxLst.pop_back();
+    state = State::TEXT;
+    return true;
+  };
 
-    bit7zCompressor.compressFile(
-      filePath.wstring(),
-      newGZipFacilityPath
-    );
-  }//end try
-  catch (const BitException& err) {
-    //do something with err.what()
-    cerr << err.what() << endl;
-    status_ += GZIP_COMPRESS_ERROR;
-    cleanNExit();
-  }//edn try compress / catch
-}//end gzipFile
+  string_view const utf8BOM = "\xEF\xBB\xBF";
+  size_t idx = 0;
+  //LOOP THRU span
+  while (idx < span.size()) {
+    //outside of the root element only white space may be text...
+    //  and a BOM at the very start
+    if (state == State::TEXT && openTagIdxLst.empty()) {
+      unsigned char chr = static_cast<unsigned char>(span[idx]);
+      size_t chrPos = docPos + idx;
+      if (chrPos < utf8BOM.size() && bomMatchLen == chrPos && chr == static_cast<unsigned char>(utf8BOM[chrPos])) {
+        ++bomMatchLen;
+        ++idx;
+        continue; //!!!GO TO NEXT CHAR!!!//
+      }
+      if (bomMatchLen != 0 && bomMatchLen != utf8BOM.size())
+        return fail(idx, "the document starts with part of a BOM");
+      if (chr != '<' && !isXMLSpace(chr)) return fail(idx, "text outside of the root element");
+      if (chr != '<') {
+        ++idx;
+        continue; //!!!GO TO NEXT CHAR!!!//
+      }
+    }//end if outside of the root element
+
+    //the states that can go on for a while skip to the next char they care about
+    if (state == State::TEXT || state == State::ATTR_VAL) {
+      idx += findXMLMarkupChar(span.substr(idx), (state == State::TEXT) ? '<' : quote);
+      if (idx == span.size()) break;
+    }
+    else if (state == State::SKIP && skipMatchLen == 0) {
+      idx = span.find(skipEnd[0], idx);
+      if (idx == string_view::npos) break;
+    }
+
+    unsigned char chr = static_cast<unsigned char>(span[idx]);
+    switch (state) {
+    case State::TEXT:
+      if (chr == '<') state = State::TAG_OPEN;
+      else {
+        markup.clear();
+        entityRtnState = State::TEXT;
+        state = State::ENTITY;
+      }
+      break;
+    case State::TAG_OPEN:
+      if (chr == '/') {
+        markup.clear();
+        state = State::END_TAG_NAME;
+      }
+      else if (chr == '?') {
+        skipEnd = "?>";
+        skipMatchLen = 0;
+        state = State::SKIP;
+      }
+      else if (chr == '!') {
+        markup.clear();
+        state = State::BANG;
+      }
+      else if (isXMLNameStart(chr)) {
+        if (openTagIdxLst.empty()) {
+          if (hasRoot) return fail(idx, "more than one root element");
+          hasRoot = true;
+        }
+        openTagIdxLst.push_back(static_cast<uint32_t>(openTagArena.size()));
+        openTagArena += static_cast<char>(chr);
+        state = State::TAG_NAME;
+      }
+      else return fail(idx, "< is not followed by a tag name");
+      break;
+    case State::TAG_NAME:
+      if (isXMLNameChar(chr)) {
+        size_t nameEnd = idx + 1;
+        while (nameEnd < span.size() && isXMLNameChar(static_cast<unsigned char>(span[nameEnd]))) ++nameEnd;
+        openTagArena.append(span.substr(idx, nameEnd - idx));
+        idx = nameEnd;
+        continue; //!!!GO TO NEXT CHAR!!!//
+      }
+      else if (isXMLSpace(chr)) state = State::IN_TAG;
+      else if (chr == '>') state = State::TEXT;
+      else if (chr == '/') state = State::EMPTY_TAG_END;
+      else return fail(idx, "bad character in a tag name");
+      break;
+    case State::IN_TAG:
+    case State::AFTER_ATTR_VAL:
+      if (chr == '>') state = State::TEXT;
+      else if (chr == '/') state = State::EMPTY_TAG_END;
+      else if (isXMLSpace(chr)) state = State::IN_TAG;
+      else if (state == State::AFTER_ATTR_VAL) return fail(idx, "attributes are not separated by a space");
+      else if (isXMLNameStart(chr)) state = State::ATTR_NAME;
+      else return fail(idx, "bad character in a tag");
+      break;
+    case State::EMPTY_TAG_END:
+      if (chr != '>') return fail(idx, "/ in a tag is not followed by >");
+      openTagArena.resize(openTagIdxLst.back());
+      openTagIdxLst.pop_back();
+      state = State::TEXT;
+      break;
+    case State::ATTR_NAME:
+      if (isXMLNameChar(chr)) {
+        while (++idx < span.size() && isXMLNameChar(static_cast<unsigned char>(span[idx])));
+        continue; //!!!GO TO NEXT CHAR!!!//
+      }
+      if (isXMLSpace(chr)) state = State::ATTR_EQ;
+      else if (chr == '=') state = State::ATTR_VAL_START;
+      else return fail(idx, "attribute without a value");
+      break;
+    case State::ATTR_EQ:
+      if (isXMLSpace(chr)) break;
+      if (chr != '=') return fail(idx, "attribute without a value");
+      state = State::ATTR_VAL_START;
+      break;
+    case State::ATTR_VAL_START:
+      if (isXMLSpace(chr)) break;
+      if (chr != '"' && chr != '\'') return fail(idx, "attribute value is not quoted");
+      quote = static_cast<char>(chr);
+      state = State::ATTR_VAL;
+      break;
+    case State::ATTR_VAL:
+      if (chr == '<') return fail(idx, "< in an attribute value");
+      if (chr == '&') {
+        markup.clear();
+        entityRtnState = State::ATTR_VAL;
+        state = State::ENTITY;
+      }
+      else state = State::AFTER_ATTR_VAL; //the closing quote
+      break;
+    case State::ENTITY:
+      if (chr != ';') {
+        if (markup.size() == maxEntityLen || !(isXMLNameChar(chr) || chr == '#'))
+          return fail(idx, "& does not start an entity");
+        markup += static_cast<char>(chr);
+      }
+      else if (!isXMLEntity(markup)) return fail(idx, "unknown entity or bad character reference: &" + markup + ";");
+      else state = entityRtnState;
+      break;
+    case State::END_TAG_NAME:
+      if (markup.empty() ? isXMLNameStart(chr) : isXMLNameChar(chr)) markup += static_cast<char>(chr);
+      else if (markup.empty()) return fail(idx, "</ is not followed by a tag name");
+      else if (isXMLSpace(chr)) state = State::END_TAG_REST;
+      else if (chr != '>') return fail(idx, "bad character in an end tag");
+      else if (!closeTag(idx)) return false;//!!! EXIT FUNCTION HERE !!!//
+      break;
+    case State::END_TAG_REST:
+      if (isXMLSpace(chr)) break;
+      if (chr != '>') return fail(idx, "bad character in an end tag");
+      if (!closeTag(idx)) return false;//!!! EXIT FUNCTION HERE !!!//
+      break;
+    case State::BANG:
+      //<!-- comment -->, <![CDATA[ ... ]]> or some other <! ... > declaration
+      markup += static_cast<char>(chr);
+      skipMatchLen = 0;
+      if (markup == "--") {
+        skipEnd = "-->";
+        state = State::SKIP;
+      }
+      else if (markup == "[CDATA[") {
+        skipEnd = "]]>";
+        state = State::SKIP;
+      }
+      else if (string_view("--").substr(0, markup.size()) != markup
+        && string_view("[CDATA[").substr(0, markup.size()) != markup) {
+        skipEnd = ">";
+        state = (chr == '>') ? State::TEXT : State::SKIP;
+      }
+      break;
+    case State::SKIP:
+      if (chr == static_cast<unsigned char>(skipEnd[skipMatchLen])) {
+        if (++skipMatchLen == skipEnd.size()) state = State::TEXT;
+      }
+      //in ---> or ]]]> the extra - or ] still leaves a match of 2
+      else if (!(skipMatchLen == 2 && chr == static_cast<unsigned char>(skipEnd[0])))
+        skipMatchLen = (chr == static_cast<unsigned char>(skipEnd[0])) ? 1 : 0;
+      break;
+    }//end switch state
+    ++idx;
+  }//END LOOP THRU span
+
+  docPos += span.size();
+  return true;
+}//end XMLValidator::feed
 
 //----------------------------------------------------------------------------
-void gzipStrm(stringstream& in, path& filePath) {
-  //try compress
-  try {
-    Bit7zLibrary lib;
-    BitStreamCompressor bit7zCompressor(lib, ::bit7z::BitFormat::GZip);
-    verifyNDelFilePath(filePath);
+bool XMLValidator::finish() {
+  if (!errMsg.empty()) return false;//!!! EXIT FUNCTION HERE !!!//
 
-    bit7zCompressor.compress(
-      in,
-      filePath
-    );
-  }//end try
-  catch (const BitException& err) {
-    //do something with err.what()
-    cerr << err.what() << endl;
-    status_ += GZIP_COMPRESS_ERROR;
-    cleanNExit();
-  }//edn try compress / catch
-}//end gzipFile
+  errPos = docPos;
+  if (state != State::TEXT)
+    errMsg = "the document ends inside a tag, entity or comment";
+  else if (!openTagIdxLst.empty())
+    errMsg = "<" + openTagArena.substr(openTagIdxLst.back()) + "> is never closed";
+  else if (!hasRoot)
+    errMsg = "the document has no root element";
+  return errMsg.empty();
+}//end XMLValidator::finish
 
 //----------------------------------------------------------------------------
-stringstream ungzip2Strm(path const& filePath) {
-  stringstream fileStrm;
+InFileBuf openInBuf(path const& filePath) {
+  InFileBuf inBuf;
+  if (!readInBuf(filePath, inBuf)) {
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("Unable to open input file path: "s + filePath.string());
+  }//end if
 
-  //try extract
-  try {
-    Bit7zLibrary lib;
-    BitExtractor bit7zExtractor(lib, ::bit7z::BitFormat::GZip);
-    
+  return inBuf;
+}//end openInBuf
+
+//----------------------------------------------------------------------------
+bool readInBuf(path const& filePath, InFileBuf& inBuf) {
+  error_code err;
+  uintmax_t fileSize = filesystem::file_size(filePath, err);
+  if (err) return false;//!!! EXIT FUNCTION HERE !!!//
+  if (fileSize == 0) return true;//!!! EXIT FUNCTION HERE !!!//
+
+  //try to map the file
+#ifdef _WIN32
+  HANDLE fileHndl = CreateFileW(
+    filePath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL
+  );
+  if (fileHndl != INVALID_HANDLE_VALUE) {
+    inBuf.mapHndl_ = CreateFileMappingW(fileHndl, NULL, PAGE_READONLY, 0, 0, NULL);
+    //the mapping keeps its own reference to the file
+    CloseHandle(fileHndl);
+    if (inBuf.mapHndl_ != NULL) {
+      inBuf.mapAddr_ = MapViewOfFile(inBuf.mapHndl_, FILE_MAP_READ, 0, 0, 0);
+      if (inBuf.mapAddr_ == NULL) {
+        CloseHandle(inBuf.mapHndl_);
+        inBuf.mapHndl_ = NULL;
+      }
+    }//end if mapping created
+  }//end if file opened
+#else
+  int fd = open(filePath.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    void* mapAddr = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    //the mapping keeps its own reference to the file
+    close(fd);
+    if (mapAddr != MAP_FAILED) {
+      madvise(mapAddr, fileSize, MADV_SEQUENTIAL);
+      inBuf.mapAddr_ = mapAddr;
+    }
+  }//end if file opened
+#endif
+  if (inBuf.mapAddr_ != nullptr) {
+    inBuf.data_ = static_cast<char const*>(inBuf.mapAddr_);
+    inBuf.size_ = static_cast<size_t>(fileSize);
+    inBuf.mapLen_ = inBuf.size_;
+    return true;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  //could not map it... fall back to one bulk read
+  ifstream inFileStrm(filePath, ios_base::in | ios_base::binary);
+  if (!inFileStrm) return false;//!!! EXIT FUNCTION HERE !!!//
+  inBuf.bulkBuf_ = make_unique<char[]>(static_cast<size_t>(fileSize));
+  inFileStrm.read(inBuf.bulkBuf_.get(), static_cast<streamsize>(fileSize));
+  inBuf.data_ = inBuf.bulkBuf_.get();
+  inBuf.size_ = static_cast<size_t>(inFileStrm.gcount());
+
+  return true;
+}//end readInBuf
+
+//----------------------------------------------------------------------------
+bool popLine(string_view& buf, string_view& line) {
+  if (buf.empty()) return false;
+
+  size_t lineEnd = buf.find('\n');
+  if (lineEnd == string_view::npos) {
+    line = buf;
+    buf = string_view();
+  }
+  else {
+    line = buf.substr(0, lineEnd);
+    buf.remove_prefix(lineEnd + 1);
+  }//end if last line ... else
+  //match text mode getline on Windows... drop the \r of a \r\n
+  if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+  return true;
+}//end popLine
+
+//----------------------------------------------------------------------------
+bool popField(string_view& buf, string_view& field, char sep) {
+  if (buf.empty()) {
+    field = string_view();
+    return false;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  size_t fieldEnd = buf.find(sep);
+  field = buf.substr(0, fieldEnd);
+  buf.remove_prefix((fieldEnd == string_view::npos) ? buf.size() : fieldEnd + 1);
+  return true;
+}//end popField
+
+//----------------------------------------------------------------------------
+bool cpuHasSSE2() {
+#if defined(_M_X64) || defined(__x86_64__)
+  return true; //always part of x86-64
+#elif defined(_MSC_VER) && defined(_M_IX86)
+  int cpuInfo[4];
+  __cpuid(cpuInfo, 1);
+  return (cpuInfo[3] & (1 << 26)) != 0;
+#elif defined(X86_SIMD)
+  return __builtin_cpu_supports("sse2");
+#else
+  return false;
+#endif
+}//end cpuHasSSE2
+
+//----------------------------------------------------------------------------
+bool cpuHasAVX2() {
+#if defined(_MSC_VER) && defined(X86_SIMD)
+  int cpuInfo[4];
+  __cpuid(cpuInfo, 0);
+  if (cpuInfo[0] < 7) return false;
+  __cpuid(cpuInfo, 1);
+  //the OS must also save the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+  if ((cpuInfo[2] & (1 << 27)) == 0) return false;
+  if ((_xgetbv(0) & 6) != 6) return false;
+  __cpuidex(cpuInfo, 7, 0);
+  return (cpuInfo[1] & (1 << 5)) != 0;
+#elif defined(X86_SIMD)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}//end cpuHasAVX2
+
+//----------------------------------------------------------------------------
+//state shared by the scanAliasLines* functions
+//  the vector scanners only feed it the positions of \n and ' ' bytes
+typedef struct AliasLineScan {
+public:
+  string_view buf;
+  vector<AliasLineIdx> lineLst;
+  size_t lineIdx = 0;
+  size_t splitIdx = string_view::npos;
+  uint32_t lineNum = 1;
+  bool dotLine = false;
+
+  explicit AliasLineScan(string_view vrcAliasBuf) : buf(vrcAliasBuf) {
+    //a rough guess that avoids most regrowth of lineLst
+    lineLst.reserve(buf.size() / 48);
+    dotLine = !buf.empty() && buf[0] == '.';
+  }
+
+  //true if the first space of the current line still needs to be found
+  bool wantSplit() const {
+    return dotLine && splitIdx == string_view::npos;
+  }
+
+  void endLine(size_t lineEnd) {
+    if (!dotLine) return;
+
+    AliasLineIdx idx;
+    idx.lineIdx = lineIdx;
+    //match text mode getline on Windows... drop the \r of a \r\n
+    if (lineEnd > lineIdx && buf[lineEnd - 1] == '\r') --lineEnd;
+    idx.lineLen = static_cast<uint32_t>(lineEnd - lineIdx);
+    idx.splitLen = (splitIdx < lineEnd)
+      ? static_cast<uint32_t>(splitIdx - lineIdx) : NO_SPLIT;
+    idx.lineNum = lineNum;
+    lineLst.push_back(idx);
+  }
+
+  void newLine(size_t nlIdx) {
+    endLine(nlIdx);
+    ++lineNum;
+    lineIdx = nlIdx + 1;
+    splitIdx = string_view::npos;
+    dotLine = lineIdx < buf.size() && buf[lineIdx] == '.';
+  }
+
+  //feeds one block of the vector scan
+  //  nlMask/spMask have bit i set if buf[blkIdx + i] is '\n'/' '
+  void feedMasks(size_t blkIdx, uint32_t nlMask, uint32_t spMask) {
+    //LOOP THRU \n (AND WANTED ' ') BYTES OF THIS BLOCK IN ORDER
+    while (true) {
+      uint32_t hitMask = wantSplit() ? (nlMask | spMask) : nlMask;
+      if (hitMask == 0) break;
+      uint32_t lowBit = hitMask & (0u - hitMask);
+      size_t hitIdx = blkIdx + ctz32(lowBit);
+      //forget every byte up to and including this one
+      uint32_t seenMask = lowBit | (lowBit - 1);
+      nlMask &= ~seenMask;
+      spMask &= ~seenMask;
+
+      if (buf[hitIdx] == '\n') newLine(hitIdx);
+      else splitIdx = hitIdx;
+    }//END LOOP THRU HITS OF THIS BLOCK
+  }
+
+  //scalar scan of buf[fromIdx...end], then closes the last line
+  void finish(size_t fromIdx) {
+    //LOOP THRU REMAINING BYTES
+    for (size_t idx = fromIdx; idx < buf.size(); ++idx) {
+      if (buf[idx] == '\n') newLine(idx);
+      else if (buf[idx] == ' ' && wantSplit()) splitIdx = idx;
+    }//END LOOP THRU REMAINING BYTES
+    if (lineIdx < buf.size()) endLine(buf.size());
+  }
+
+  static int ctz32(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long bitIdx;
+    _BitScanForward(&bitIdx, mask);
+    return static_cast<int>(bitIdx);
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+} AliasLineScan;
+
+//----------------------------------------------------------------------------
+vector<AliasLineIdx> scanAliasLines(string_view vrcAliasBuf, uint32_t& lineCnt) {
+  using ScanFn = vector<AliasLineIdx>(*)(string_view, uint32_t&);
+  //resolve once, the CPU is not going to change under us
+  ScanFn static const scanFn = []() -> ScanFn {
+#ifdef X86_SIMD
+    if (cpuHasAVX2()) return scanAliasLinesAVX2;
+    if (cpuHasSSE2()) return scanAliasLinesSSE2;
+#endif
+    return scanAliasLinesScalar;
+  }();
+
+  return scanFn(vrcAliasBuf, lineCnt);
+}//end scanAliasLines
+
+//----------------------------------------------------------------------------
+vector<AliasLineIdx> scanAliasLinesScalar(string_view vrcAliasBuf, uint32_t& lineCnt) {
+  AliasLineScan scan(vrcAliasBuf);
+  scan.finish(0);
+  lineCnt = scan.lineNum - 1;
+  return move(scan.lineLst);
+}//end scanAliasLinesScalar
+
+#ifdef X86_SIMD
+//----------------------------------------------------------------------------
+TARGET_SSE2 vector<AliasLineIdx> scanAliasLinesSSE2(string_view vrcAliasBuf, uint32_t& lineCnt) {
+  AliasLineScan scan(vrcAliasBuf);
+  char const* data = vrcAliasBuf.data();
+  size_t const blkLen = sizeof(__m128i);
+  __m128i const nlVec = _mm_set1_epi8('\n');
+  __m128i const spVec = _mm_set1_epi8(' ');
+
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS
+  for (; blkIdx + blkLen <= vrcAliasBuf.size(); blkIdx += blkLen) {
+    __m128i blk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + blkIdx));
+    uint32_t nlMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(blk, nlVec)));
+    uint32_t spMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(blk, spVec)));
+    if ((nlMask | spMask) != 0) scan.feedMasks(blkIdx, nlMask, spMask);
+  }//END LOOP THRU FULL BLOCKS
+  scan.finish(blkIdx);
+  lineCnt = scan.lineNum - 1;
+
+  return move(scan.lineLst);
+}//end scanAliasLinesSSE2
+
+//----------------------------------------------------------------------------
+TARGET_AVX2 vector<AliasLineIdx> scanAliasLinesAVX2(string_view vrcAliasBuf, uint32_t& lineCnt) {
+  AliasLineScan scan(vrcAliasBuf);
+  char const* data = vrcAliasBuf.data();
+  size_t const blkLen = sizeof(__m256i);
+  __m256i const nlVec = _mm256_set1_epi8('\n');
+  __m256i const spVec = _mm256_set1_epi8(' ');
+
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS
+  for (; blkIdx + blkLen <= vrcAliasBuf.size(); blkIdx += blkLen) {
+    __m256i blk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + blkIdx));
+    uint32_t nlMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(blk, nlVec)));
+    uint32_t spMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(blk, spVec)));
+    if ((nlMask | spMask) != 0) scan.feedMasks(blkIdx, nlMask, spMask);
+  }//END LOOP THRU FULL BLOCKS
+  scan.finish(blkIdx);
+  lineCnt = scan.lineNum - 1;
+
+  return move(scan.lineLst);
+}//end scanAliasLinesAVX2
+#endif
+
+//----------------------------------------------------------------------------
+size_t findHighByte(string_view buf) {
+  using FindFn = size_t(*)(string_view);
+  //resolve once, the CPU is not going to change under us
+  FindFn static const findFn = []() -> FindFn {
+#ifdef X86_SIMD
+    if (cpuHasAVX2()) return findHighByteAVX2;
+    if (cpuHasSSE2()) return findHighByteSSE2;
+#endif
+    return findHighByteScalar;
+  }();
+
+  return findFn(buf);
+}//end findHighByte
+
+//----------------------------------------------------------------------------
+size_t findHighByteScalar(string_view buf) {
+  for (size_t idx = 0; idx < buf.size(); ++idx)
+    if (static_cast<unsigned char>(buf[idx]) >= 0x80) return idx;
+  return buf.size();
+}//end findHighByteScalar
+
+#ifdef X86_SIMD
+//----------------------------------------------------------------------------
+TARGET_SSE2 size_t findHighByteSSE2(string_view buf) {
+  char const* data = buf.data();
+  size_t const blkLen = sizeof(__m128i);
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS... the sign bits are exactly the high bytes
+  for (; blkIdx + blkLen <= buf.size(); blkIdx += blkLen) {
+    __m128i blk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + blkIdx));
+    uint32_t highMask = static_cast<uint32_t>(_mm_movemask_epi8(blk));
+    if (highMask != 0) return blkIdx + AliasLineScan::ctz32(highMask);
+  }//END LOOP THRU FULL BLOCKS
+
+  return blkIdx + findHighByteScalar(buf.substr(blkIdx));
+}//end findHighByteSSE2
+
+//----------------------------------------------------------------------------
+TARGET_AVX2 size_t findHighByteAVX2(string_view buf) {
+  char const* data = buf.data();
+  size_t const blkLen = sizeof(__m256i);
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS... the sign bits are exactly the high bytes
+  for (; blkIdx + blkLen <= buf.size(); blkIdx += blkLen) {
+    __m256i blk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + blkIdx));
+    uint32_t highMask = static_cast<uint32_t>(_mm256_movemask_epi8(blk));
+    if (highMask != 0) return blkIdx + AliasLineScan::ctz32(highMask);
+  }//END LOOP THRU FULL BLOCKS
+
+  return blkIdx + findHighByteScalar(buf.substr(blkIdx));
+}//end findHighByteAVX2
+#endif
+
+//----------------------------------------------------------------------------
+bool isUTF8(string_view buf, size_t fromIdx) {
+  size_t idx = fromIdx;
+  //LOOP THRU MULTI-BYTE SEQUENCES
+  while ((idx += findHighByte(buf.substr(idx))) < buf.size()) {
+    unsigned char leadByte = static_cast<unsigned char>(buf[idx]);
+    size_t seqLen;
+    uint32_t codePt;
+    if (leadByte >= 0xC2 && leadByte <= 0xDF) { seqLen = 2; codePt = leadByte & 0x1F; }
+    else if (leadByte >= 0xE0 && leadByte <= 0xEF) { seqLen = 3; codePt = leadByte & 0x0F; }
+    else if (leadByte >= 0xF0 && leadByte <= 0xF4) { seqLen = 4; codePt = leadByte & 0x07; }
+    else return false;
+    if (idx + seqLen > buf.size()) return false;
+
+    for (size_t contIdx = 1; contIdx < seqLen; ++contIdx) {
+      unsigned char contByte = static_cast<unsigned char>(buf[idx + contIdx]);
+      if ((contByte & 0xC0) != 0x80) return false;
+      codePt = (codePt << 6) | (contByte & 0x3F);
+    }
+    //no overlong forms, surrogates or code points past U+10FFFF
+    if ((seqLen == 3 && codePt < 0x800) || (seqLen == 4 && codePt < 0x10000)
+        || (codePt >= 0xD800 && codePt <= 0xDFFF) || codePt > 0x10FFFF)
+      return false;
+    idx += seqLen;
+  }//END LOOP THRU MULTI-BYTE SEQUENCES
+
+  return true;
+}//end isUTF8
+
+//----------------------------------------------------------------------------
+string cp1252ToUTF8(string_view buf, size_t firstHighIdx) {
+  //the code points of 0x80 - 0x9F, the only part that is not Latin-1
+  //  the 5 unassigned bytes map to the matching C1 controls, like Windows
+  uint16_t static const CP1252_80_9F[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+  };
+
+  string utf8;
+  //worst case every remaining byte becomes 3 bytes
+  utf8.reserve(firstHighIdx + 3 * (buf.size() - firstHighIdx));
+  utf8.append(buf.substr(0, firstHighIdx));
+  size_t idx = firstHighIdx;
+  //LOOP THRU BYTES (RUNS OF ASCII ARE COPIED WHOLE)
+  while (idx < buf.size()) {
+    size_t asciiLen = findHighByte(buf.substr(idx));
+    utf8.append(buf.substr(idx, asciiLen));
+    idx += asciiLen;
+    if (idx >= buf.size()) break;
+
+    unsigned char highByte = static_cast<unsigned char>(buf[idx++]);
+    uint32_t codePt = (highByte < 0xA0) ? CP1252_80_9F[highByte - 0x80] : highByte;
+    if (codePt < 0x800) {
+      utf8 += static_cast<char>(0xC0 | (codePt >> 6));
+      utf8 += static_cast<char>(0x80 | (codePt & 0x3F));
+    }
+    else {
+      utf8 += static_cast<char>(0xE0 | (codePt >> 12));
+      utf8 += static_cast<char>(0x80 | ((codePt >> 6) & 0x3F));
+      utf8 += static_cast<char>(0x80 | (codePt & 0x3F));
+    }//end if 2 byte ... else 3 byte
+  }//END LOOP THRU BYTES
+
+  return utf8;
+}//end cp1252ToUTF8
+
+//----------------------------------------------------------------------------
+TextEnc normalizeInBuf(InFileBuf& inBuf) {
+  string_view buf = inBuf.view();
+  if (buf.size() >= 2 && ((buf[0] == '\xFF' && buf[1] == '\xFE') || (buf[0] == '\xFE' && buf[1] == '\xFF')))
+    return TextEnc::UTF16;//!!! EXIT FUNCTION HERE !!!//
+  if (buf.substr(0, 3) == "\xEF\xBB\xBF") {
+    inBuf.data_ += 3;
+    inBuf.size_ -= 3;
+    buf.remove_prefix(3);
+  }//end if UTF-8 BOM
+
+  //the common case... one vector pass and nothing else
+  size_t firstHighIdx = findHighByte(buf);
+  if (firstHighIdx == buf.size()) return TextEnc::ASCII;//!!! EXIT FUNCTION HERE !!!//
+  if (isUTF8(buf, firstHighIdx)) return TextEnc::UTF8;//!!! EXIT FUNCTION HERE !!!//
+
+  string utf8 = cp1252ToUTF8(buf, firstHighIdx);
+  InFileBuf utf8Buf;
+  utf8Buf.bulkBuf_ = make_unique<char[]>(utf8.size());
+  memcpy(utf8Buf.bulkBuf_.get(), utf8.data(), utf8.size());
+  utf8Buf.data_ = utf8Buf.bulkBuf_.get();
+  utf8Buf.size_ = utf8.size();
+  inBuf = move(utf8Buf);
+
+  return TextEnc::CP1252;
+}//end normalizeInBuf
+
+//----------------------------------------------------------------------------
+ofstream openOutStrm(path& filePath, bool const& force) {
+  if(!force) verifyFilePath(filePath);
+
+  ofstream outFileStrm(filePath, ios_base::out|ios_base::trunc);
+  if (!outFileStrm) {
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("Unable to open output file path: "s + filePath.string());
+  }//end if
+
+  return outFileStrm;
+}//end openOutStrm(path&)
+
+//----------------------------------------------------------------------------
+ofstream openOutStrm(path&& filePath, bool const& force) {
+  if (!force) verifyFilePath(filePath);
+
+  ofstream outFileStrm(filePath, ios_base::out | ios_base::trunc);
+  if (!outFileStrm) {
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("Unable to open output file path: "s + filePath.string());
+  }//end if
+
+  return outFileStrm;
+}//end openOutStrm(path&&)
+
+//----------------------------------------------------------------------------
+void escapeXML(string& str) {
+  size_t rawLen = str.size();
+  size_t firstEscIdx = findXMLEscChar(str);
+  if (firstEscIdx == rawLen) return;//!!! EXIT FUNCTION HERE !!!//
+  size_t escLen = firstEscIdx + getEscXMLLen(string_view(str).substr(firstEscIdx));
+
+  str.resize(escLen);
+  char* strBuf = str.data();
+  char* outPos = strBuf + escLen;
+  //LOOP THRU str BACKWARDS
+  //  the escaped text ends at or after the raw text it replaces,
+  //  so nothing is overwritten before it has been read
+  for (size_t charIdx = rawLen; charIdx-- > 0 && outPos != strBuf + charIdx + 1;) {
+    char chr = strBuf[charIdx];
+    switch (chr) {
+    case '&':  outPos -= 5; memcpy(outPos, "&amp;", 5); break;
+    case '"':  outPos -= 6; memcpy(outPos, "&quot;", 6); break;
+    case '\'': outPos -= 6; memcpy(outPos, "&apos;", 6); break;
+    case '<':  outPos -= 4; memcpy(outPos, "&lt;", 4); break;
+    default:   *--outPos = chr; break;
+    }
+  }//END LOOP THRU str
+  //...once outPos catches up, the rest of str is already in place
+}//end escapeXML
+
+//----------------------------------------------------------------------------
+void appendEscXML(string& out, string_view str) {
+  size_t firstEscIdx = findXMLEscChar(str);
+  if (firstEscIdx == str.size()) {
+    out.append(str);
+    return;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  size_t outIdx = out.size();
+  out.resize(outIdx + firstEscIdx + getEscXMLLen(str.substr(firstEscIdx)));
+  char* outPos = out.data() + outIdx;
+  memcpy(outPos, str.data(), firstEscIdx);
+  outPos += firstEscIdx;
+  //LOOP THRU str FROM THE FIRST CHARACTER THAT NEEDS ESCAPING
+  for (size_t charIdx = firstEscIdx; charIdx < str.size(); ++charIdx) {
+    char chr = str[charIdx];
+    switch (chr) {
+    case '&':  memcpy(outPos, "&amp;", 5); outPos += 5; break;
+    case '"':  memcpy(outPos, "&quot;", 6); outPos += 6; break;
+    case '\'': memcpy(outPos, "&apos;", 6); outPos += 6; break;
+    case '<':  memcpy(outPos, "&lt;", 4); outPos += 4; break;
+    default:   *outPos++ = chr; break;
+    }
+  }//END LOOP THRU str
+}//end appendEscXML
+
+//----------------------------------------------------------------------------
+template <size_t AttrCnt, typename... Vals>
+void appendXMLElem(string& out, XMLElemFmt<AttrCnt> const& fmt, Vals const&... valLst) {
+  static_assert(sizeof...(Vals) == AttrCnt, "one value per attribute");
+  size_t attrIdx = 0;
+  ((out += fmt.frag(attrIdx++), appendXMLVal(out, valLst)), ...);
+  out += fmt.frag(AttrCnt);
+}//end appendXMLElem
+
+//----------------------------------------------------------------------------
+void appendXMLVal(string& out, string_view val) {
+  appendEscXML(out, val);
+}//end appendXMLVal(string_view)
+
+//----------------------------------------------------------------------------
+void appendXMLVal(string& out, XMLRaw val) {
+  out += val.str;
+}//end appendXMLVal(XMLRaw)
+
+//----------------------------------------------------------------------------
+void appendXMLVal(string& out, char val) {
+  out += val;
+}//end appendXMLVal(char)
+
+//----------------------------------------------------------------------------
+template <size_t AttrCnt, typename... Vals>
+size_t getXMLElemLen(XMLElemFmt<AttrCnt> const& fmt, Vals const&... valLst) {
+  static_assert(sizeof...(Vals) == AttrCnt, "one value per attribute");
+  return (fmt.fixedLen() + ... + getXMLValLen(valLst));
+}//end getXMLElemLen
+
+//----------------------------------------------------------------------------
+size_t getXMLValLen(string_view val) {
+  return getEscXMLLen(val);
+}//end getXMLValLen(string_view)
+
+//----------------------------------------------------------------------------
+size_t getXMLValLen(XMLRaw val) {
+  return val.str.size();
+}//end getXMLValLen(XMLRaw)
+
+//----------------------------------------------------------------------------
+size_t getXMLValLen(char) {
+  return 1;
+}//end getXMLValLen(char)
+
+//----------------------------------------------------------------------------
+template <size_t AttrCnt, typename... Raws>
+char* writeXMLElem(char* outPos, XMLElemFmt<AttrCnt> const& fmt, Raws... valLst) {
+  static_assert(sizeof...(Raws) == AttrCnt, "one value per attribute");
+  static_assert((is_same_v<Raws, XMLRaw> && ...), "only XMLRaw values can be written in place");
+  size_t attrIdx = 0;
+  string_view frag;
+  ((frag = fmt.frag(attrIdx++), outPos = copy(frag.begin(), frag.end(), outPos),
+    outPos = copy(valLst.str.begin(), valLst.str.end(), outPos)), ...);
+  frag = fmt.frag(AttrCnt);
+  return copy(frag.begin(), frag.end(), outPos);
+}//end writeXMLElem
+
+//----------------------------------------------------------------------------
+XMLElemFmt<2> const& getCommandAliasFmt() {
+  return opts_.compact ? COMMAND_ALIAS_COMPACT_FMT : COMMAND_ALIAS_FMT;
+}//end getCommandAliasFmt
+
+//----------------------------------------------------------------------------
+XMLElemFmt<8> const& getPositionInfoFmt() {
+  return opts_.compact ? POSITION_INFO_COMPACT_FMT : POSITION_INFO_FMT;
+}//end getPositionInfoFmt
+
+//----------------------------------------------------------------------------
+string getBlockIndent() {
+  return opts_.compact ? string() : BLOCK_INDENT;
+}//end getBlockIndent
+
+//----------------------------------------------------------------------------
+size_t getEscXMLLen(string_view str) {
+  size_t firstEscIdx = findXMLEscChar(str);
+  size_t escLen = str.size();
+  for (size_t charIdx = firstEscIdx; charIdx < str.size(); ++charIdx)
+    escLen += ESC_XML_EXTRA_LEN[static_cast<unsigned char>(str[charIdx])];
+  return escLen;
+}//end getEscXMLLen
+
+//----------------------------------------------------------------------------
+size_t findXMLEscChar(string_view str) {
+  using FindFn = size_t(*)(string_view);
+  //resolve once, the CPU is not going to change under us
+  FindFn static const findFn = []() -> FindFn {
+#ifdef X86_SIMD
+    if (cpuHasAVX2()) return findXMLEscCharAVX2;
+    if (cpuHasSSE2()) return findXMLEscCharSSE2;
+#endif
+    return findXMLEscCharScalar;
+  }();
+
+  return findFn(str);
+}//end findXMLEscChar
+
+//----------------------------------------------------------------------------
+size_t findXMLEscCharScalar(string_view str) {
+  for (size_t idx = 0; idx < str.size(); ++idx)
+    if (ESC_XML_EXTRA_LEN[static_cast<unsigned char>(str[idx])] != 0) return idx;
+  return str.size();
+}//end findXMLEscCharScalar
+
+#ifdef X86_SIMD
+//----------------------------------------------------------------------------
+TARGET_SSE2 size_t findXMLEscCharSSE2(string_view str) {
+  char const* data = str.data();
+  size_t const blkLen = sizeof(__m128i);
+  __m128i const ampVec = _mm_set1_epi8('&');
+  __m128i const quotVec = _mm_set1_epi8('"');
+  __m128i const aposVec = _mm_set1_epi8('\'');
+  __m128i const ltVec = _mm_set1_epi8('<');
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS
+  for (; blkIdx + blkLen <= str.size(); blkIdx += blkLen) {
+    __m128i blk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + blkIdx));
+    __m128i escVec = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(blk, ampVec), _mm_cmpeq_epi8(blk, quotVec)),
+      _mm_or_si128(_mm_cmpeq_epi8(blk, aposVec), _mm_cmpeq_epi8(blk, ltVec))
+    );
+    uint32_t escMask = static_cast<uint32_t>(_mm_movemask_epi8(escVec));
+    if (escMask != 0) return blkIdx + AliasLineScan::ctz32(escMask);
+  }//END LOOP THRU FULL BLOCKS
+
+  return blkIdx + findXMLEscCharScalar(str.substr(blkIdx));
+}//end findXMLEscCharSSE2
+
+//----------------------------------------------------------------------------
+TARGET_AVX2 size_t findXMLEscCharAVX2(string_view str) {
+  char const* data = str.data();
+  size_t const blkLen = sizeof(__m256i);
+  __m256i const ampVec = _mm256_set1_epi8('&');
+  __m256i const quotVec = _mm256_set1_epi8('"');
+  __m256i const aposVec = _mm256_set1_epi8('\'');
+  __m256i const ltVec = _mm256_set1_epi8('<');
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS
+  for (; blkIdx + blkLen <= str.size(); blkIdx += blkLen) {
+    __m256i blk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + blkIdx));
+    __m256i escVec = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(blk, ampVec), _mm256_cmpeq_epi8(blk, quotVec)),
+      _mm256_or_si256(_mm256_cmpeq_epi8(blk, aposVec), _mm256_cmpeq_epi8(blk, ltVec))
+    );
+    uint32_t escMask = static_cast<uint32_t>(_mm256_movemask_epi8(escVec));
+    if (escMask != 0) return blkIdx + AliasLineScan::ctz32(escMask);
+  }//END LOOP THRU FULL BLOCKS
+
+  //the tail is usually long enough for one SSE2 block
+  return blkIdx + findXMLEscCharSSE2(str.substr(blkIdx));
+}//end findXMLEscCharAVX2
+#endif
+
+//----------------------------------------------------------------------------
+size_t findXMLMarkupChar(string_view str, char quote) {
+  using FindFn = size_t(*)(string_view, char);
+  //resolve once, the CPU is not going to change under us
+  FindFn static const findFn = []() -> FindFn {
+#ifdef X86_SIMD
+    if (cpuHasAVX2()) return findXMLMarkupCharAVX2;
+    if (cpuHasSSE2()) return findXMLMarkupCharSSE2;
+#endif
+    return findXMLMarkupCharScalar;
+  }();
+
+  return findFn(str, quote);
+}//end findXMLMarkupChar
+
+//----------------------------------------------------------------------------
+size_t findXMLMarkupCharScalar(string_view str, char quote) {
+  for (size_t idx = 0; idx < str.size(); ++idx)
+    if (str[idx] == '<' || str[idx] == '&' || str[idx] == quote) return idx;
+  return str.size();
+}//end findXMLMarkupCharScalar
+
+#ifdef X86_SIMD
+//----------------------------------------------------------------------------
+TARGET_SSE2 size_t findXMLMarkupCharSSE2(string_view str, char quote) {
+  char const* data = str.data();
+  size_t const blkLen = sizeof(__m128i);
+  __m128i const ltVec = _mm_set1_epi8('<');
+  __m128i const ampVec = _mm_set1_epi8('&');
+  __m128i const quoteVec = _mm_set1_epi8(quote);
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS
+  for (; blkIdx + blkLen <= str.size(); blkIdx += blkLen) {
+    __m128i blk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + blkIdx));
+    __m128i markupVec = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(blk, ltVec), _mm_cmpeq_epi8(blk, ampVec)),
+      _mm_cmpeq_epi8(blk, quoteVec)
+    );
+    uint32_t markupMask = static_cast<uint32_t>(_mm_movemask_epi8(markupVec));
+    if (markupMask != 0) return blkIdx + AliasLineScan::ctz32(markupMask);
+  }//END LOOP THRU FULL BLOCKS
+
+  return blkIdx + findXMLMarkupCharScalar(str.substr(blkIdx), quote);
+}//end findXMLMarkupCharSSE2
+
+//----------------------------------------------------------------------------
+TARGET_AVX2 size_t findXMLMarkupCharAVX2(string_view str, char quote) {
+  char const* data = str.data();
+  size_t const blkLen = sizeof(__m256i);
+  __m256i const ltVec = _mm256_set1_epi8('<');
+  __m256i const ampVec = _mm256_set1_epi8('&');
+  __m256i const quoteVec = _mm256_set1_epi8(quote);
+  size_t blkIdx = 0;
+  //LOOP THRU FULL BLOCKS
+  for (; blkIdx + blkLen <= str.size(); blkIdx += blkLen) {
+    __m256i blk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + blkIdx));
+    __m256i markupVec = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(blk, ltVec), _mm256_cmpeq_epi8(blk, ampVec)),
+      _mm256_cmpeq_epi8(blk, quoteVec)
+    );
+    uint32_t markupMask = static_cast<uint32_t>(_mm256_movemask_epi8(markupVec));
+    if (markupMask != 0) return blkIdx + AliasLineScan::ctz32(markupMask);
+  }//END LOOP THRU FULL BLOCKS
+
+  //the tail is usually long enough for one SSE2 block
+  return blkIdx + findXMLMarkupCharSSE2(str.substr(blkIdx), quote);
+}//end findXMLMarkupCharAVX2
+#endif
+
+//----------------------------------------------------------------------------
+vector<path> parseAliasSrcArg(string const& aliasSrcArg) {
+  vector<path> srcPathLst;
+  string_view argLeft = aliasSrcArg;
+  //LOOP THRU SEPARATED PATHS
+  while (!argLeft.empty()) {
+    size_t sepIdx = argLeft.find(ALIAS_SRC_SEP);
+    path srcPath(argLeft.substr(0, sepIdx));
+    argLeft.remove_prefix((sepIdx == string_view::npos) ? argLeft.size() : sepIdx + 1);
+    if (srcPath.empty()) continue; //!!!GO TO NEXT PATH!!!//
+
+    error_code err;
+    if (filesystem::is_directory(srcPath, err)) {
+      vector<path> dirPathLst;
+      for (filesystem::directory_entry const& dirEntry : filesystem::directory_iterator(srcPath, err))
+        if (dirEntry.is_regular_file(err) && dirEntry.path().extension() != ALIAS_CACHE_EXT)
+          dirPathLst.push_back(dirEntry.path());
+      sort(dirPathLst.begin(), dirPathLst.end());
+      srcPathLst.insert(srcPathLst.end(), dirPathLst.begin(), dirPathLst.end());
+    }
+    else if (filesystem::is_regular_file(srcPath, err))
+      srcPathLst.push_back(srcPath);
+    else {
+      status_ += OPEN_FILE_FAILURE;
+      prntNExit("Unable to open input file path: "s + srcPath.string());
+    }//end if directory ... else if file ... else
+  }//END LOOP THRU SEPARATED PATHS
+
+  if (srcPathLst.empty()) {
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("No VRC alias files found in: "s + aliasSrcArg);
+  }
+
+  return srcPathLst;
+}//end parseAliasSrcArg
+
+//----------------------------------------------------------------------------
+vector<AliasSrc> mapAliasSrcs(vector<path> const& srcPathLst) {
+  vector<AliasSrc> srcLst(srcPathLst.size());
+  vector<char> loadedLst(srcPathLst.size(), false);
+  runTasks(srcLst.size(), [&](size_t srcIdx) {
+    AliasSrc& src = srcLst[srcIdx];
+    src.srcPath = srcPathLst[srcIdx];
+    loadedLst[srcIdx] = readInBuf(srcPathLst[srcIdx], src.buf);
+    src.rawSize = src.buf.size_;
+    src.rawHash = hashBytes(src.buf.view());
+  });
+  //report from this thread... prntNExit is not safe on the workers
+  for (size_t srcIdx = 0; srcIdx < srcLst.size(); ++srcIdx) {
+    if (loadedLst[srcIdx]) continue; //!!!GO TO NEXT SOURCE!!!//
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("Unable to open input file path: "s + srcPathLst[srcIdx].string());
+  }//end for each source
+
+  return srcLst;
+}//end mapAliasSrcs
+
+//----------------------------------------------------------------------------
+void scanAliasSrcs(vector<AliasSrc>& srcLst) {
+  runTasks(srcLst.size(), [&](size_t srcIdx) {
+    srcLst[srcIdx].enc = normalizeInBuf(srcLst[srcIdx].buf);
+  });
+  //report from this thread... prntNExit is not safe on the workers
+  for (AliasSrc const& src : srcLst) {
+    if (src.enc == TextEnc::UTF16) {
+      status_ += INPUT_ENCODING;
+      prntNExit("UTF-16 input is not supported, save as ANSI or UTF-8: "s + src.srcPath.string());
+    }
+    if (src.enc == TextEnc::CP1252)
+      cout << "Converted " << src.srcPath.string() << " from Windows-1252 to UTF-8" << endl;
+  }//end for each source
+
+  //scan every source in newline aligned chunks... big files are split
+  //  across threads, small files just get one chunk each
+  typedef struct ScanTask {
+    uint32_t srcIdx;
+    string_view chunk;
+    vector<AliasLineIdx> lineLst;
+    uint32_t lineCnt;
+  } ScanTask;
+  size_t maxChunkCnt = 4 * max(1u, thread::hardware_concurrency());
+  vector<ScanTask> taskLst;
+  for (uint32_t srcIdx = 0; srcIdx < srcLst.size(); ++srcIdx) {
+    string_view srcBuf = srcLst[srcIdx].buf.view();
+    size_t chunkCnt = min(maxChunkCnt, srcBuf.size() / MIN_CHUNK_LEN + 1);
+    for (string_view chunk : splitAtLines(srcBuf, chunkCnt))
+      taskLst.push_back(ScanTask{ srcIdx, chunk, {}, 0 });
+  }//end for each source
+  runTasks(taskLst.size(), [&](size_t taskIdx) {
+    ScanTask& task = taskLst[taskIdx];
+    task.lineLst = scanAliasLines(task.chunk, task.lineCnt);
+    //make the offsets relative to the whole source again
+    size_t chunkIdx = task.chunk.data() - srcLst[task.srcIdx].buf.view().data();
+    for (AliasLineIdx& aliasLineIdx : task.lineLst) aliasLineIdx.lineIdx += chunkIdx;
+  });
+  //reassemble each source's line list in order
+  //  and make the line numbers relative to the whole source too
+  uint32_t prevSrcIdx = UINT32_MAX, lineNumOffset = 0;
+  for (ScanTask& task : taskLst) {
+    if (task.srcIdx != prevSrcIdx) lineNumOffset = 0;
+    prevSrcIdx = task.srcIdx;
+    vector<AliasLineIdx>& lineLst = srcLst[task.srcIdx].lineLst;
+    for (AliasLineIdx& aliasLineIdx : task.lineLst) aliasLineIdx.lineNum += lineNumOffset;
+    lineLst.insert(lineLst.end(), task.lineLst.begin(), task.lineLst.end());
+    lineNumOffset += task.lineCnt;
+  }
+}//end scanAliasSrcs
+
+//----------------------------------------------------------------------------
+uint64_t hashBytes(string_view buf) {
+  uint64_t const MUL = 0x9E3779B97F4A7C15ull;
+  uint64_t hash = (buf.size() + 1) * MUL;
+  uint64_t word;
+  size_t idx = 0;
+  //LOOP THRU WHOLE 8 BYTE WORDS
+  for (; idx + sizeof(word) <= buf.size(); idx += sizeof(word)) {
+    memcpy(&word, buf.data() + idx, sizeof(word));
+    hash = (hash ^ word) * MUL;
+    hash ^= hash >> 32;
+  }//END LOOP THRU WHOLE WORDS
+  word = 0;
+  memcpy(&word, buf.data() + idx, buf.size() - idx);
+  hash = (hash ^ word) * MUL;
+
+  return hash ^ (hash >> 29);
+}//end hashBytes
+
+//----------------------------------------------------------------------------
+//ASCII only... VRC commands are plain ASCII and this skips the locale
+static inline unsigned char foldCase(char cmdChar) {
+  unsigned char foldChar = static_cast<unsigned char>(cmdChar);
+  return (foldChar >= 'A' && foldChar <= 'Z') ? foldChar + ('a' - 'A') : foldChar;
+}//end foldCase
+
+//----------------------------------------------------------------------------
+bool isAliasStrmArg(string const& aliasSrcArg) {
+  if (aliasSrcArg == "-") return true;
+#ifdef _WIN32
+  if (aliasSrcArg.rfind("\\\\.\\pipe\\", 0) == 0) return true;
+#endif
+  error_code err;
+  return filesystem::is_fifo(path(aliasSrcArg), err);
+}//end isAliasStrmArg
+
+//----------------------------------------------------------------------------
+FILE* openAliasStrm(string const& aliasSrcArg) {
+  if (aliasSrcArg == "-") {
+#ifdef _WIN32
+    //keep the \r of \r\n, the same as mapped files
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    return stdin;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  FILE* strm = fopen(aliasSrcArg.c_str(), "rb");
+  if (strm == nullptr) {
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("Unable to open input file path: "s + aliasSrcArg);
+  }
+
+  return strm;
+}//end openAliasStrm
+
+//----------------------------------------------------------------------------
+LineStrmReader::LineStrmReader(FILE* strm, size_t bufLen)
+  : strm(strm), buf(make_unique<char[]>(bufLen + 2)), bufLen(bufLen), bufCap(bufLen + 2)
+{
+  //reads go straight into buf, the FILE does not need a buffer of its own
+  setvbuf(strm, nullptr, _IONBF, 0);
+}//end LineStrmReader::LineStrmReader
+
+//----------------------------------------------------------------------------
+bool LineStrmReader::nextLine(string_view& line) {
+  //LOOP UNTIL A WHOLE LINE IS IN buf
+  while (true) {
+    char* lineBeg = buf.get() + headIdx;
+    char* nlPos = static_cast<char*>(memchr(buf.get() + scanIdx, '\n', tailIdx - scanIdx));
+    if (nlPos != nullptr || (atEOF && headIdx < tailIdx)) {
+      size_t lineEnd = (nlPos != nullptr) ? nlPos - buf.get() : tailIdx;
+      line = string_view(lineBeg, lineEnd - headIdx);
+      headIdx = scanIdx = (nlPos != nullptr) ? lineEnd + 1 : tailIdx;
+      //match text mode getline on Windows... drop the \r of a \r\n
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+      if (line.size() > bufLen) {
+        lineTooLong = true;
+        return false;//!!! EXIT FUNCTION HERE !!!//
+      }
+      ++lineNum;
+      return true;//!!! EXIT FUNCTION HERE !!!//
+    }
+    if (atEOF) return false;//!!! EXIT FUNCTION HERE !!!//
+
+    //slide the partial line to the front of buf and read more after it
+    if (headIdx > 0) {
+      memmove(buf.get(), lineBeg, tailIdx - headIdx);
+      tailIdx -= headIdx;
+      headIdx = 0;
+    }
+    scanIdx = tailIdx;
+    if (tailIdx == bufCap) {
+      lineTooLong = true;
+      return false;//!!! EXIT FUNCTION HERE !!!//
+    }
+    size_t readLen = fread(buf.get() + tailIdx, 1, bufCap - tailIdx, strm);
+    tailIdx += readLen;
+    if (readLen == 0) {
+      atEOF = true;
+      if (ferror(strm)) return false;//!!! EXIT FUNCTION HERE !!!//
+    }
+  }//END LOOP UNTIL A WHOLE LINE IS IN buf
+}//end LineStrmReader::nextLine
+
+//----------------------------------------------------------------------------
+size_t CmdHash::operator()(string_view cmd) const {
+  //FNV-1a of the lower case command
+  uint64_t hash = 14695981039346656037ull;
+  for (char cmdChar : cmd) {
+    hash ^= foldCase(cmdChar);
+    hash *= 1099511628211ull;
+  }
+  return static_cast<size_t>(hash ^ (hash >> 32));
+}//end CmdHash::operator()
+
+//----------------------------------------------------------------------------
+bool CmdEq::operator()(string_view lhs, string_view rhs) const {
+  if (lhs.size() != rhs.size()) return false;
+  for (size_t charIdx = 0; charIdx < lhs.size(); ++charIdx)
+    if (foldCase(lhs[charIdx]) != foldCase(rhs[charIdx])) return false;
+  return true;
+}//end CmdEq::operator()
+
+//----------------------------------------------------------------------------
+CmdIdx::CmdIdx(size_t maxCmdCnt) {
+  //keep the load factor at or under 1/2
+  size_t slotCnt = 16;
+  while (slotCnt < 2 * maxCmdCnt) slotCnt *= 2;
+  slotLst.resize(slotCnt);
+  slotMask = slotCnt - 1;
+}//end CmdIdx::CmdIdx
+
+//----------------------------------------------------------------------------
+uint32_t& CmdIdx::findOrAdd(string_view cmd, uint32_t val, bool& isNew) {
+  uint32_t hash = static_cast<uint32_t>(CmdHash()(cmd));
+  size_t slotIdx = hash & slotMask;
+  //LOOP THRU PROBE SEQUENCE
+  while (true) {
+    Slot& slot = slotLst[slotIdx];
+    if (slot.cmd == nullptr) {
+      slot.cmd = cmd.data();
+      slot.cmdLen = static_cast<uint32_t>(cmd.size());
+      slot.hash = hash;
+      slot.val = val;
+      isNew = true;
+      return slot.val;//!!! EXIT FUNCTION HERE !!!//
+    }
+    if (slot.hash == hash && CmdEq()(string_view(slot.cmd, slot.cmdLen), cmd)) {
+      isNew = false;
+      return slot.val;//!!! EXIT FUNCTION HERE !!!//
+    }
+    slotIdx = (slotIdx + 1) & slotMask;
+  }//END LOOP THRU PROBE SEQUENCE
+}//end CmdIdx::findOrAdd
+
+//----------------------------------------------------------------------------
+uint32_t const* CmdIdx::find(string_view cmd) const {
+  uint32_t hash = static_cast<uint32_t>(CmdHash()(cmd));
+  size_t slotIdx = hash & slotMask;
+  //LOOP THRU PROBE SEQUENCE
+  while (slotLst[slotIdx].cmd != nullptr) {
+    Slot const& slot = slotLst[slotIdx];
+    if (slot.hash == hash && CmdEq()(string_view(slot.cmd, slot.cmdLen), cmd))
+      return &slot.val;//!!! EXIT FUNCTION HERE !!!//
+    slotIdx = (slotIdx + 1) & slotMask;
+  }//END LOOP THRU PROBE SEQUENCE
+  return nullptr;
+}//end CmdIdx::find
+
+//----------------------------------------------------------------------------
+void AliasTable::useOwners() {
+  aliasCnt = cmdIdxOwner.size();
+  arena = arenaOwner.data();
+  arenaLen = arenaOwner.size();
+  cmdIdxLst = cmdIdxOwner.data();
+  cmdLenLst = cmdLenOwner.data();
+  rplcmntIdxLst = rplcmntIdxOwner.data();
+  rplcmntLenLst = rplcmntLenOwner.data();
+}//end AliasTable::useOwners
+
+//----------------------------------------------------------------------------
+string_view getAliasCmd(string_view vrcAliasBuf, AliasLineIdx const& aliasLineIdx) {
+  size_t cmdNameLen = (aliasLineIdx.splitLen == NO_SPLIT)
+    ? aliasLineIdx.lineLen : aliasLineIdx.splitLen;
+  return vrcAliasBuf.substr(aliasLineIdx.lineIdx, cmdNameLen);
+}//end getAliasCmd
+
+//----------------------------------------------------------------------------
+string_view getAliasRplcmnt(string_view vrcAliasBuf, AliasLineIdx const& aliasLineIdx) {
+  if (aliasLineIdx.splitLen == NO_SPLIT)
+    return vrcAliasBuf.substr(aliasLineIdx.lineIdx, aliasLineIdx.lineLen);
+  size_t rplcmntIdx = aliasLineIdx.splitLen + 1;
+  return vrcAliasBuf.substr(
+    aliasLineIdx.lineIdx + rplcmntIdx, aliasLineIdx.lineLen - rplcmntIdx
+  );
+}//end getAliasRplcmnt
+
+//----------------------------------------------------------------------------
+void buildAliasTable(vector<AliasSrc> const& srcLst, AliasTable& aliasTable) {
+  vector<AliasRef>& refLst = aliasTable.refLst;
+  refLst.clear();
+  for (uint32_t srcIdx = 0; srcIdx < srcLst.size(); ++srcIdx)
+    for (uint32_t lineIdx = 0; lineIdx < srcLst[srcIdx].lineLst.size(); ++lineIdx)
+      refLst.push_back(AliasRef{ srcIdx, lineIdx });
+  aliasTable.cmdIdxOwner.resize(refLst.size());
+  aliasTable.cmdLenOwner.resize(refLst.size());
+  aliasTable.rplcmntIdxOwner.resize(refLst.size());
+  aliasTable.rplcmntLenOwner.resize(refLst.size());
+
+  size_t chunkCnt = 4 * max(1u, thread::hardware_concurrency());
+  chunkCnt = min(chunkCnt, refLst.size() / MIN_CHUNK_ALIASES + 1);
+  vector<string> chunkArenaLst(chunkCnt);
+  //prntd from this thread once all chunks are done, in source order
+  vector<string> chunkLintMsgsLst(chunkCnt);
+  vector<uint32_t> chunkLintCntLst(chunkCnt, 0);
+  vector<string> srcNameLst;
+  for (AliasSrc const& src : srcLst) srcNameLst.push_back(src.srcPath.string());
+  runTasks(chunkCnt, [&](size_t chunkIdx) {
+    string& chunkArena = chunkArenaLst[chunkIdx];
+    //reused for every alias of the chunk, so it stops allocating
+    //  once it has grown to the longest one
+    vector<AliasTok> tokLst;
+    size_t firstIdx = refLst.size() * chunkIdx / chunkCnt;
+    size_t lastIdx = refLst.size() * (chunkIdx + 1) / chunkCnt;
+    //the lines are the size of the arena unless they need escaping
+    size_t rawLen = 0;
+    for (size_t aliasIdx = firstIdx; aliasIdx < lastIdx; ++aliasIdx)
+      rawLen += srcLst[refLst[aliasIdx].srcIdx].lineLst[refLst[aliasIdx].lineIdx].lineLen;
+    chunkArena.reserve(rawLen + rawLen / 8);
+    //LOOP THRU ALIASES OF THIS CHUNK
+    for (size_t aliasIdx = firstIdx; aliasIdx < lastIdx; ++aliasIdx) {
+      string_view srcBuf = srcLst[refLst[aliasIdx].srcIdx].buf.view();
+      AliasLineIdx const& aliasLineIdx = srcLst[refLst[aliasIdx].srcIdx].lineLst[refLst[aliasIdx].lineIdx];
+
+      //offsets are relative to this chunk until the chunks are joined
+      size_t escIdx = chunkArena.size();
+      appendEscXML(chunkArena, getAliasCmd(srcBuf, aliasLineIdx));
+      aliasTable.cmdIdxOwner[aliasIdx] = static_cast<uint32_t>(escIdx);
+      aliasTable.cmdLenOwner[aliasIdx] = static_cast<uint32_t>(chunkArena.size() - escIdx);
+
+      string_view rplcmnt = getAliasRplcmnt(srcBuf, aliasLineIdx);
+      if (opts_.lint) {
+        chunkLintCntLst[chunkIdx] += lintAliasBody(
+          getAliasCmd(srcBuf, aliasLineIdx), rplcmnt, aliasLineIdx.splitLen != NO_SPLIT,
+          srcNameLst[refLst[aliasIdx].srcIdx], aliasLineIdx.lineNum,
+          tokLst, chunkLintMsgsLst[chunkIdx]
+        );
+      }
+      escIdx = chunkArena.size();
+      appendEscXML(chunkArena, rplcmnt);
+      aliasTable.rplcmntIdxOwner[aliasIdx] = static_cast<uint32_t>(escIdx);
+      aliasTable.rplcmntLenOwner[aliasIdx] = static_cast<uint32_t>(chunkArena.size() - escIdx);
+    }//END LOOP THRU ALIASES OF THIS CHUNK
+  });
+
+  size_t arenaLen = 0;
+  for (string const& chunkArena : chunkArenaLst) arenaLen += chunkArena.size();
+  aliasTable.arenaOwner.clear();
+  aliasTable.arenaOwner.reserve(arenaLen);
+  for (size_t chunkIdx = 0; chunkIdx < chunkCnt; ++chunkIdx) {
+    uint32_t chunkOffset = static_cast<uint32_t>(aliasTable.arenaOwner.size());
+    size_t lastIdx = refLst.size() * (chunkIdx + 1) / chunkCnt;
+    for (size_t aliasIdx = refLst.size() * chunkIdx / chunkCnt; aliasIdx < lastIdx; ++aliasIdx) {
+      aliasTable.cmdIdxOwner[aliasIdx] += chunkOffset;
+      aliasTable.rplcmntIdxOwner[aliasIdx] += chunkOffset;
+    }
+    aliasTable.arenaOwner += chunkArenaLst[chunkIdx];
+  }//end for each chunk
+
+  aliasTable.lintCnt = 0;
+  for (size_t chunkIdx = 0; chunkIdx < chunkCnt; ++chunkIdx) {
+    cerr << chunkLintMsgsLst[chunkIdx];
+    aliasTable.lintCnt += chunkLintCntLst[chunkIdx];
+  }
+  reportAliasLint(aliasTable.lintCnt);
+
+  aliasTable.useOwners();
+}//end buildAliasTable
+
+//----------------------------------------------------------------------------
+void mergeAliasTable(vector<AliasSrc> const& srcLst, AliasTable& aliasTable) {
+  uint32_t static const NO_PREV = UINT32_MAX;
+  vector<AliasRef>& refLst = aliasTable.refLst;
+  size_t aliasCnt = aliasTable.aliasCnt;
+
+  //most recent definition of each command (index into the table)
+  //  escaping does not change which commands are equal
+  CmdIdx cmdIdx(aliasCnt);
+  //earlier definition of the same command in the same source
+  vector<uint32_t> prevDefLst(aliasCnt, NO_PREV);
+  vector<char> keepLst(aliasCnt, true);
+  uint32_t& dupCnt = aliasTable.dupCnt;
+  uint32_t& overrideCnt = aliasTable.overrideCnt;
+  dupCnt = overrideCnt = 0;
+  auto srcLoc = [&](uint32_t aliasIdx) {
+    AliasSrc const& src = srcLst[refLst[aliasIdx].srcIdx];
+    return src.srcPath.string() + ":" + to_string(src.lineLst[refLst[aliasIdx].lineIdx].lineNum);
+  };
+  //as it was written, for messages
+  auto rawCmd = [&](uint32_t aliasIdx) {
+    AliasSrc const& src = srcLst[refLst[aliasIdx].srcIdx];
+    return getAliasCmd(src.buf.view(), src.lineLst[refLst[aliasIdx].lineIdx]);
+  };
+
+  //LOOP THRU ALIASES IN SOURCE ORDER
+  for (uint32_t aliasIdx = 0; aliasIdx < aliasCnt; ++aliasIdx) {
+    bool isNew;
+    uint32_t& lastDefIdx = cmdIdx.findOrAdd(aliasTable.cmd(aliasIdx), aliasIdx, isNew);
+    if (isNew) continue; //!!!GO TO NEXT ALIAS!!!//
+
+    uint32_t prevIdx = lastDefIdx;
+    lastDefIdx = aliasIdx;
+    bool sameSrc = refLst[prevIdx].srcIdx == refLst[aliasIdx].srcIdx;
+    if (sameSrc) {
+      ++dupCnt;
+      cerr << "Warning: duplicate alias \"" << rawCmd(aliasIdx) << "\" at " << srcLoc(aliasIdx)
+           << " (also defined at " << srcLoc(prevIdx) << ")" << endl;
+    }
+    else {
+      ++overrideCnt;
+      cout << "Alias \"" << rawCmd(aliasIdx) << "\" at " << srcLoc(aliasIdx)
+           << " overrides " << srcLoc(prevIdx) << endl;
+    }//end if sameSrc ... else
+
+    if (sameSrc && !opts_.dropDups) {
+      prevDefLst[aliasIdx] = prevIdx;
+      continue; //!!!GO TO NEXT ALIAS!!!//
+    }
+    //drop all of the earlier definitions
+    for (uint32_t dropIdx = prevIdx; dropIdx != NO_PREV; dropIdx = prevDefLst[dropIdx])
+      keepLst[dropIdx] = false;
+  }//END LOOP THRU ALIASES
+
+  reportAliasMerge(dupCnt, overrideCnt);
+
+  //compact the columns... the arena keeps the bytes of dropped aliases
+  size_t keptCnt = 0;
+  for (size_t aliasIdx = 0; aliasIdx < aliasCnt; ++aliasIdx) {
+    if (!keepLst[aliasIdx]) continue; //!!!GO TO NEXT ALIAS!!!//
+    refLst[keptCnt] = refLst[aliasIdx];
+    aliasTable.cmdIdxOwner[keptCnt] = aliasTable.cmdIdxOwner[aliasIdx];
+    aliasTable.cmdLenOwner[keptCnt] = aliasTable.cmdLenOwner[aliasIdx];
+    aliasTable.rplcmntIdxOwner[keptCnt] = aliasTable.rplcmntIdxOwner[aliasIdx];
+    aliasTable.rplcmntLenOwner[keptCnt] = aliasTable.rplcmntLenOwner[aliasIdx];
+    ++keptCnt;
+  }
+  refLst.resize(keptCnt);
+  aliasTable.cmdIdxOwner.resize(keptCnt);
+  aliasTable.cmdLenOwner.resize(keptCnt);
+  aliasTable.rplcmntIdxOwner.resize(keptCnt);
+  aliasTable.rplcmntLenOwner.resize(keptCnt);
+  aliasTable.useOwners();
+}//end mergeAliasTable
+
+//----------------------------------------------------------------------------
+void reportAliasMerge(uint32_t dupCnt, uint32_t overrideCnt) {
+  if (overrideCnt != 0)
+    cout << overrideCnt << " alias(es) overridden by later alias files" << endl;
+  if (dupCnt != 0) {
+    status_ += DUP_ALIASES;
+    cerr << "Warning: " << dupCnt << " duplicate alias(es) found... "
+         << (opts_.dropDups ? "only the last definition of each was kept" : "all definitions were kept")
+         << endl;
+  }
+}//end reportAliasMerge
+
+//----------------------------------------------------------------------------
+AliasBuiltin const* findAliasBuiltin(string_view name) {
+  //[first, last) of the ALIAS_BUILTIN_LST entries for each first letter
+  static_assert(size(ALIAS_BUILTIN_LST) <= UINT8_MAX, "letterRangeLst holds uint8_t indexes");
+  static array<pair<uint8_t, uint8_t>, 26> const letterRangeLst = [] {
+    array<pair<uint8_t, uint8_t>, 26> rangeLst = {};
+    for (size_t builtinIdx = size(ALIAS_BUILTIN_LST); builtinIdx-- > 0;) {
+      pair<uint8_t, uint8_t>& range = rangeLst[ALIAS_BUILTIN_LST[builtinIdx].name[0] - 'a'];
+      if (range.second == 0) range.second = static_cast<uint8_t>(builtinIdx + 1);
+      range.first = static_cast<uint8_t>(builtinIdx);
+    }
+    return rangeLst;
+  }();
+
+  if (name.empty()) return nullptr;//!!! EXIT FUNCTION HERE !!!//
+  unsigned char letterIdx = foldCase(name[0]) - 'a';
+  if (letterIdx >= letterRangeLst.size()) return nullptr;//!!! EXIT FUNCTION HERE !!!//
+  for (size_t builtinIdx = letterRangeLst[letterIdx].first; builtinIdx < letterRangeLst[letterIdx].second; ++builtinIdx)
+    if (CmdEq()(ALIAS_BUILTIN_LST[builtinIdx].name, name)) return &ALIAS_BUILTIN_LST[builtinIdx];//!!! EXIT FUNCTION HERE !!!//
+
+  return nullptr;
+}//end findAliasBuiltin
+
+//----------------------------------------------------------------------------
+uint32_t tokenizeAliasBody(string_view body, vector<AliasTok>& tokLst, uint32_t& strayCloseCnt) {
+  tokLst.clear();
+  strayCloseCnt = 0;
+  uint32_t callDepth = 0; //FUNC calls not closed yet
+  //open ( inside of calls (including the calls themselves) as a bit stack,
+  //  a set bit is a call... past 64 deep they all count as plain (
+  uint64_t openCallBits = 0;
+  uint32_t openCnt = 0;
+  size_t textIdx = 0; //start of the TEXT token being collected
+  auto addTok = [&](AliasTokKind kind, size_t idx, size_t len) {
+    if (textIdx < idx)
+      tokLst.push_back(AliasTok{ AliasTokKind::TEXT, uint32_t(textIdx), uint32_t(idx - textIdx) });
+    tokLst.push_back(AliasTok{ kind, uint32_t(idx), uint32_t(len) });
+    textIdx = idx + len;
+  };
+
+  auto getCharClass = [&](size_t idx) {
+    return ALIAS_TOK_CHAR_LST[static_cast<unsigned char>(body[idx])];
+  };
+  size_t charIdx = 0;
+  //LOOP THRU body
+  while (charIdx < body.size()) {
+    while (charIdx < body.size() && !(getCharClass(charIdx) & ALIAS_TOK_STOP)) ++charIdx;
+    if (charIdx == body.size()) break; //!!!EXIT LOOP!!!//
+
+    char chr = body[charIdx];
+    if (chr == '(') {
+      if (openCnt < 64) openCallBits &= ~(uint64_t(1) << openCnt);
+      ++openCnt;
+      ++charIdx;
+      continue; //!!!GO TO NEXT CHAR!!!//
+    }
+    if (chr == ')') {
+      if (openCnt == 0) {
+        ++strayCloseCnt;
+        ++charIdx;
+        continue; //!!!GO TO NEXT CHAR!!!//
+      }
+      --openCnt;
+      if (openCnt < 64 && (openCallBits >> openCnt & 1)) {
+        addTok(AliasTokKind::CALL_END, charIdx, 1);
+        --callDepth;
+      }
+      ++charIdx;
+      continue; //!!!GO TO NEXT CHAR!!!//
+    }
+
+    //chr is '$'
+    size_t nameEnd = charIdx + 1;
+    uint8_t nameClass = ALIAS_TOK_DIGIT;
+    while (nameEnd < body.size() && (getCharClass(nameEnd) & ALIAS_TOK_NAME)) nameClass &= getCharClass(nameEnd++);
+    if (nameEnd == charIdx + 1) {
+      ++charIdx; //a lone $ is just TEXT
+      continue; //!!!GO TO NEXT CHAR!!!//
+    }
+    if (nameEnd < body.size() && body[nameEnd] == '(') {
+      addTok(AliasTokKind::FUNC, charIdx, nameEnd + 1 - charIdx);
+      if (openCnt < 64) {
+        openCallBits |= uint64_t(1) << openCnt;
+        ++callDepth;
+      }
+      ++openCnt;
+    }
+    else {
+      //all digits is a $1, $2... PARAM
+      addTok((nameClass & ALIAS_TOK_DIGIT) ? AliasTokKind::PARAM : AliasTokKind::VAR, charIdx, nameEnd - charIdx);
+    }
+    charIdx = textIdx;
+  }//END LOOP THRU body
+  if (textIdx < body.size())
+    tokLst.push_back(AliasTok{ AliasTokKind::TEXT, uint32_t(textIdx), uint32_t(body.size() - textIdx) });
+
+  return callDepth;
+}//end tokenizeAliasBody
+
+//----------------------------------------------------------------------------
+uint32_t lintAliasBody(
+  string_view cmd, string_view body, bool hasBody,
+  string_view srcName, uint32_t lineNum,
+  vector<AliasTok>& tokLst, string& lintMsgs
+) {
+  uint32_t problemCnt = 0;
+  auto addProblem = [&](string_view problem, string_view name) {
+    ++problemCnt;
+    lintMsgs += "Warning: alias \"";
+    lintMsgs += cmd;
+    lintMsgs += "\" at ";
+    if (srcName.empty()) lintMsgs += "line ";
+    else {
+      lintMsgs += srcName;
+      lintMsgs += ':';
+    }
+    lintMsgs += to_string(lineNum);
+    lintMsgs += ": ";
+    lintMsgs += problem;
+    if (!name.empty()) {
+      lintMsgs += ": ";
+      lintMsgs += name;
+    }
+    lintMsgs += '\n';
+  };
+
+  if (!hasBody || body.find_first_not_of(" \t") == string_view::npos) {
+    addProblem("has no replacement", "");
+    return problemCnt;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  uint32_t strayCloseCnt;
+  uint32_t openCallCnt = tokenizeAliasBody(body, tokLst, strayCloseCnt);
+  //LOOP THRU TOKENS
+  for (AliasTok const& tok : tokLst) {
+    if (tok.kind != AliasTokKind::VAR && tok.kind != AliasTokKind::FUNC) continue; //!!!GO TO NEXT TOKEN!!!//
+    bool isFunc = tok.kind == AliasTokKind::FUNC;
+    string_view name = body.substr(tok.idx + 1, tok.len - (isFunc ? 2 : 1));
+    string_view tokText = body.substr(tok.idx, tok.len);
+
+    AliasBuiltin const* builtin = findAliasBuiltin(name);
+    if (builtin == nullptr) addProblem(isFunc ? "unknown function" : "unknown variable", tokText);
+    else if (builtin->isFunc && !isFunc) addProblem("function used without (", tokText);
+    else if (!builtin->isFunc && isFunc) addProblem("variable used as a function", tokText);
+  }//END LOOP THRU TOKENS
+  if (openCallCnt != 0)
+    addProblem("unbalanced parentheses, calls left open", to_string(openCallCnt));
+  if (strayCloseCnt != 0)
+    addProblem("unbalanced parentheses, ) without a (", to_string(strayCloseCnt));
+
+  return problemCnt;
+}//end lintAliasBody
+
+//----------------------------------------------------------------------------
+void reportAliasLint(uint32_t lintCnt) {
+  if (lintCnt == 0) return;//!!! EXIT FUNCTION HERE !!!//
+  if (opts_.lintStrict) status_ += ALIAS_LINT;
+  cerr << "Warning: " << lintCnt << " problem(s) found in alias replacements" << endl;
+}//end reportAliasLint
+
+//----------------------------------------------------------------------------
+AliasEngine::AliasEngine(AliasTable const& aliasTable) : cmdIdx(aliasTable.aliasCnt) {
+  string body;
+  vector<AliasTok> tokLst;
+  firstOpLst.reserve(aliasTable.aliasCnt + 1);
+  cmdIdxLst.reserve(aliasTable.aliasCnt);
+  cmdLenLst.reserve(aliasTable.aliasCnt);
+  textArena.reserve(aliasTable.arenaLen);
+  //LOOP THRU ALIASES... COMPILE EACH ONE
+  for (size_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx) {
+    firstOpLst.push_back(static_cast<uint32_t>(opLst.size()));
+    cmdIdxLst.push_back(static_cast<uint32_t>(textArena.size()));
+    appendUnescXML(textArena, aliasTable.cmd(aliasIdx));
+    cmdLenLst.push_back(static_cast<uint32_t>(textArena.size() - cmdIdxLst.back()));
+
+    //the ops point into the copy of the body in textArena
+    uint32_t bodyIdx = static_cast<uint32_t>(textArena.size());
+    appendUnescXML(textArena, aliasTable.rplcmnt(aliasIdx));
+    string_view body(textArena.data() + bodyIdx, textArena.size() - bodyIdx);
+    uint32_t strayCloseCnt; //the lint reports them, here they are just TEXT
+    tokenizeAliasBody(body, tokLst, strayCloseCnt);
+    //LOOP THRU TOKENS
+    for (AliasTok const& tok : tokLst) {
+      ExpandOp op;
+      op.idx = bodyIdx + tok.idx;
+      op.len = tok.len;
+      switch (tok.kind) {
+      case AliasTokKind::TEXT:
+        op.kind = ExpandOpKind::TEXT;
+        break;
+      case AliasTokKind::PARAM:
+        op.kind = ExpandOpKind::PARAM;
+        op.val = static_cast<uint32_t>(strtoul(body.data() + tok.idx + 1, nullptr, 10));
+        break;
+      case AliasTokKind::VAR:
+      case AliasTokKind::FUNC: {
+        bool isFunc = tok.kind == AliasTokKind::FUNC;
+        op.kind = isFunc ? ExpandOpKind::CALL : ExpandOpKind::VAR;
+        ++op.idx; //skip the $ (and the ( of a call)
+        op.len -= isFunc ? 2 : 1;
+        AliasBuiltin const* builtin = findAliasBuiltin(body.substr(tok.idx + 1, op.len));
+        op.val = (builtin == nullptr) ? NO_BUILTIN : static_cast<uint32_t>(builtin - ALIAS_BUILTIN_LST);
+        break;
+      }
+      case AliasTokKind::CALL_END:
+        op.kind = ExpandOpKind::CALL_END;
+        break;
+      }//end switch tok.kind
+      opLst.push_back(op);
+    }//END LOOP THRU TOKENS
+  }//END LOOP THRU ALIASES
+  firstOpLst.push_back(static_cast<uint32_t>(opLst.size()));
+
+  //textArena is complete, so the commands can be indexed now
+  for (uint32_t aliasIdx = 0; aliasIdx < cmdIdxLst.size(); ++aliasIdx) {
+    bool isNew;
+    cmdIdx.findOrAdd(string_view(textArena.data() + cmdIdxLst[aliasIdx], cmdLenLst[aliasIdx]), aliasIdx, isNew)
+      = aliasIdx;
+  }
+}//end AliasEngine::AliasEngine
+
+//----------------------------------------------------------------------------
+bool AliasEngine::expand(string_view cmdLine, ExpandCtx const& ctx, string& expansion) const {
+  expansion.clear();
+  string nextCmdLine;
+  vector<string_view> paramLst;
+  //LOOP THRU NESTED ALIASES
+  for (uint32_t depth = 0; depth <= ALIAS_EXPAND_MAX_DEPTH; ++depth) {
+    //split into the command and its parameters
+    paramLst.clear();
+    size_t wordIdx = cmdLine.find_first_not_of(' ');
+    while (wordIdx != string_view::npos) {
+      size_t wordEnd = min(cmdLine.find(' ', wordIdx), cmdLine.size());
+      paramLst.push_back(cmdLine.substr(wordIdx, wordEnd - wordIdx));
+      wordIdx = cmdLine.find_first_not_of(' ', wordEnd);
+    }
+    if (paramLst.empty() || paramLst[0][0] != '.') {
+      if (depth == 0) return false;//!!! EXIT FUNCTION HERE !!!//
+      break; //!!!EXIT LOOP!!!//
+    }
+
+    uint32_t const* aliasIdx = cmdIdx.find(paramLst[0]);
+    if (aliasIdx == nullptr) {
+      if (depth == 0) return false;//!!! EXIT FUNCTION HERE !!!//
+      break; //!!!EXIT LOOP!!!// ...the result is just not an alias
+    }
+
+    expansion.clear();
+    run(*aliasIdx, paramLst, ctx, expansion);
+    nextCmdLine.swap(expansion);
+    cmdLine = nextCmdLine;
+  }//END LOOP THRU NESTED ALIASES
+  if (expansion.data() != cmdLine.data()) expansion.assign(cmdLine);
+
+  return true;
+}//end AliasEngine::expand
+
+//----------------------------------------------------------------------------
+void AliasEngine::run(
+  size_t aliasIdx, vector<string_view> const& paramLst,
+  ExpandCtx const& ctx, string& expansion
+) const {
+  //open calls: the CALL op and where its argument starts in expansion
+  vector<pair<ExpandOp const*, size_t>> callLst;
+  string funcKey;
+  ExpandOp const* lastOp = opLst.data() + firstOpLst[aliasIdx + 1];
+  //LOOP THRU OPS OF THIS ALIAS
+  for (ExpandOp const* op = opLst.data() + firstOpLst[aliasIdx]; op != lastOp; ++op) {
+    string_view text(textArena.data() + op->idx, op->len);
+    switch (op->kind) {
+    case ExpandOpKind::TEXT:
+      expansion += text;
+      break;
+    case ExpandOpKind::PARAM:
+      if (op->val < paramLst.size()) expansion += paramLst[op->val];
+      break;
+    case ExpandOpKind::VAR:
+      if (op->val != NO_BUILTIN) {
+        if (op->val < ctx.builtinValLst.size()) expansion += ctx.builtinValLst[op->val];
+      }
+      else {
+        funcKey.clear();
+        for (char chr : text) funcKey += static_cast<char>(foldCase(chr));
+        auto valIt = ctx.varValLst.find(funcKey);
+        if (valIt != ctx.varValLst.end()) expansion += valIt->second;
+      }
+      break;
+    case ExpandOpKind::CALL:
+      callLst.push_back({ op, expansion.size() });
+      break;
+    case ExpandOpKind::CALL_END: {
+      ExpandOp const* callOp = callLst.back().first;
+      size_t argIdx = callLst.back().second;
+      callLst.pop_back();
+      string_view name(textArena.data() + callOp->idx, callOp->len);
+      //$uc() and $lc() are done here, everything else comes from ctx
+      if (CmdEq()(name, "uc") || CmdEq()(name, "lc")) {
+        bool toUpper = CmdEq()(name, "uc");
+        for (size_t charIdx = argIdx; charIdx < expansion.size(); ++charIdx)
+          expansion[charIdx] = static_cast<char>(
+            toUpper ? toupper(static_cast<unsigned char>(expansion[charIdx])) : foldCase(expansion[charIdx])
+          );
+        break; //!!!GO TO NEXT OP!!!//
+      }
+      funcKey.clear();
+      for (char chr : name) funcKey += static_cast<char>(foldCase(chr));
+      funcKey += '(';
+      for (size_t charIdx = argIdx; charIdx < expansion.size(); ++charIdx)
+        funcKey += static_cast<char>(foldCase(expansion[charIdx]));
+      funcKey += ')';
+      expansion.resize(argIdx);
+      auto valIt = ctx.funcValLst.find(funcKey);
+      if (valIt != ctx.funcValLst.end()) expansion += valIt->second;
+      break;
+    }
+    }//end switch op->kind
+  }//END LOOP THRU OPS
+  //a call that was never closed gets the text after it as its argument...
+  //  leave that text as it is
+}//end AliasEngine::run
+
+//----------------------------------------------------------------------------
+AliasGraph::AliasGraph(AliasTable const& aliasTable) {
+  //the escaped commands can be compared as they are...
+  //  escaping does not change which commands are equal
+  CmdIdx cmdIdx(aliasTable.aliasCnt);
+  for (uint32_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx) {
+    bool isNew;
+    cmdIdx.findOrAdd(aliasTable.cmd(aliasIdx), aliasIdx, isNew) = aliasIdx;
+  }
+
+  firstEdgeLst.reserve(aliasTable.aliasCnt + 1);
+  //LOOP THRU ALIASES
+  for (uint32_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx) {
+    firstEdgeLst.push_back(static_cast<uint32_t>(edgeLst.size()));
+    string_view rplcmnt = aliasTable.rplcmnt(aliasIdx);
+    //an alias with no replacement has its command as the replacement...
+    //  that is not a ref to itself (the lint reports it)
+    if (rplcmnt == aliasTable.cmd(aliasIdx)) continue; //!!!GO TO NEXT ALIAS!!!//
+    size_t wordIdx = rplcmnt.find_first_not_of(' ');
+    if (wordIdx == string_view::npos || rplcmnt[wordIdx] != '.') continue; //!!!GO TO NEXT ALIAS!!!//
+    string_view word = rplcmnt.substr(wordIdx, rplcmnt.find(' ', wordIdx) - wordIdx);
+
+    //only a word that is an alias is a ref... the index is never added to
+    //  here, so words like .msg do not end up in it
+    uint32_t const* refIdx = cmdIdx.find(word);
+    if (refIdx != nullptr) edgeLst.push_back(*refIdx);
+  }//END LOOP THRU ALIASES
+  firstEdgeLst.push_back(static_cast<uint32_t>(edgeLst.size()));
+}//end AliasGraph::AliasGraph
+
+//----------------------------------------------------------------------------
+uint32_t findAliasSCCs(AliasGraph const& aliasGraph, vector<uint32_t>& sccIdLst) {
+  uint32_t static const UNVISITED = UINT32_MAX;
+  size_t nodeCnt = aliasGraph.firstEdgeLst.size() - 1;
+  vector<uint32_t> visitIdxLst(nodeCnt, UNVISITED); //Tarjan's index
+  vector<uint32_t> lowLinkLst(nodeCnt, 0);
+  vector<char> onStackLst(nodeCnt, false);
+  vector<uint32_t> nodeStack;
+  //the recursion of the textbook version: the node and its next edge
+  vector<pair<uint32_t, uint32_t>> callStack;
+  sccIdLst.assign(nodeCnt, UNVISITED);
+  uint32_t visitCnt = 0, sccCnt = 0;
+
+  //LOOP THRU ROOTS
+  for (uint32_t rootIdx = 0; rootIdx < nodeCnt; ++rootIdx) {
+    if (visitIdxLst[rootIdx] != UNVISITED) continue; //!!!GO TO NEXT ROOT!!!//
+    auto visit = [&](uint32_t nodeIdx) {
+      visitIdxLst[nodeIdx] = lowLinkLst[nodeIdx] = visitCnt++;
+      nodeStack.push_back(nodeIdx);
+      onStackLst[nodeIdx] = true;
+      callStack.push_back({ nodeIdx, aliasGraph.firstEdgeLst[nodeIdx] });
+    };
+    visit(rootIdx);
+
+    //LOOP UNTIL THE DFS FROM rootIdx IS DONE
+    while (!callStack.empty()) {
+      uint32_t nodeIdx = callStack.back().first;
+      uint32_t& edgeIdx = callStack.back().second;
+      if (edgeIdx < aliasGraph.firstEdgeLst[nodeIdx + 1]) {
+        uint32_t refIdx = aliasGraph.edgeLst[edgeIdx++];
+        if (visitIdxLst[refIdx] == UNVISITED) visit(refIdx);
+        else if (onStackLst[refIdx]) lowLinkLst[nodeIdx] = min(lowLinkLst[nodeIdx], visitIdxLst[refIdx]);
+        continue; //!!!GO TO NEXT EDGE!!!//
+      }
+
+      //all refs of nodeIdx are done... "return" to its caller
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        uint32_t callerIdx = callStack.back().first;
+        lowLinkLst[callerIdx] = min(lowLinkLst[callerIdx], lowLinkLst[nodeIdx]);
+      }
+      if (lowLinkLst[nodeIdx] != visitIdxLst[nodeIdx]) continue; //!!!GO TO NEXT NODE!!!//
+
+      //nodeIdx is the root of a component... pop it off
+      uint32_t memberIdx;
+      do {
+        memberIdx = nodeStack.back();
+        nodeStack.pop_back();
+        onStackLst[memberIdx] = false;
+        sccIdLst[memberIdx] = sccCnt;
+      } while (memberIdx != nodeIdx);
+      ++sccCnt;
+    }//END LOOP UNTIL DFS IS DONE
+  }//END LOOP THRU ROOTS
+
+  return sccCnt;
+}//end findAliasSCCs
+
+//----------------------------------------------------------------------------
+uint32_t reportAliasGraph(AliasTable const& aliasTable) {
+  uint32_t static const UNBOUNDED = UINT32_MAX;
+  AliasGraph aliasGraph(aliasTable);
+  if (aliasGraph.edgeLst.empty()) return 0;//!!! EXIT FUNCTION HERE !!!// ...no alias runs another
+
+  vector<uint32_t> sccIdLst;
+  uint32_t sccCnt = findAliasSCCs(aliasGraph, sccIdLst);
+  //members of each component, in alias order
+  vector<uint32_t> firstMemberLst(sccCnt + 1, 0), memberLst(sccIdLst.size());
+  for (uint32_t sccId : sccIdLst) ++firstMemberLst[sccId + 1];
+  for (uint32_t sccId = 0; sccId < sccCnt; ++sccId) firstMemberLst[sccId + 1] += firstMemberLst[sccId];
+  {
+    vector<uint32_t> nextMemberLst(firstMemberLst.begin(), firstMemberLst.end() - 1);
+    for (uint32_t aliasIdx = 0; aliasIdx < sccIdLst.size(); ++aliasIdx)
+      memberLst[nextMemberLst[sccIdLst[aliasIdx]]++] = aliasIdx;
+  }
+
+  //components are numbered so that every ref goes to the same or a lower
+  //  one, so one pass in that order sees all refs of a component done
+  vector<uint32_t> sccDepthLst(sccCnt, 1);
+  uint32_t cycleCnt = 0, maxDepth = 0, maxDepthAlias = 0;
+  string cmd;
+  //LOOP THRU COMPONENTS
+  for (uint32_t sccId = 0; sccId < sccCnt; ++sccId) {
+    uint32_t& depth = sccDepthLst[sccId];
+    bool isCycle = firstMemberLst[sccId + 1] - firstMemberLst[sccId] > 1;
+    for (uint32_t memberPos = firstMemberLst[sccId]; memberPos < firstMemberLst[sccId + 1]; ++memberPos) {
+      uint32_t aliasIdx = memberLst[memberPos];
+      for (uint32_t edgeIdx = aliasGraph.firstEdgeLst[aliasIdx]; edgeIdx < aliasGraph.firstEdgeLst[aliasIdx + 1]; ++edgeIdx) {
+        uint32_t refSccId = sccIdLst[aliasGraph.edgeLst[edgeIdx]];
+        if (refSccId == sccId) isCycle = true; //also catches an alias that runs itself
+        else if (sccDepthLst[refSccId] == UNBOUNDED) depth = UNBOUNDED;
+        else if (depth != UNBOUNDED) depth = max(depth, sccDepthLst[refSccId] + 1);
+      }
+    }
+    if (!isCycle) {
+      if (depth != UNBOUNDED && depth > maxDepth) {
+        maxDepth = depth;
+        maxDepthAlias = memberLst[firstMemberLst[sccId]];
+      }
+      continue; //!!!GO TO NEXT COMPONENT!!!//
+    }
+
+    depth = UNBOUNDED;
+    ++cycleCnt;
+    cerr << "Warning: aliases run each other in a cycle:";
+    for (uint32_t memberPos = firstMemberLst[sccId]; memberPos < firstMemberLst[sccId + 1]; ++memberPos) {
+      cmd.clear();
+      appendUnescXML(cmd, aliasTable.cmd(memberLst[memberPos]));
+      cerr << ' ' << cmd;
+    }
+    cerr << endl;
+  }//END LOOP THRU COMPONENTS
+
+  if (maxDepth > 1) {
+    cmd.clear();
+    appendUnescXML(cmd, aliasTable.cmd(maxDepthAlias));
+    cout << "Maximum alias expansion depth: " << maxDepth << " (" << cmd << ")" << endl;
+  }
+  if (cycleCnt != 0) {
+    status_ += ALIAS_CYCLE;
+    cerr << "Warning: " << cycleCnt << " alias cycle(s) found" << endl;
+  }
+
+  return cycleCnt;
+}//end reportAliasGraph
+
+//----------------------------------------------------------------------------
+CmdPrefixIdx::CmdPrefixIdx(AliasTable const& aliasTable) {
+  vector<uint32_t> idxLst(aliasTable.aliasCnt), lenLst(aliasTable.aliasCnt);
+  for (size_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx) {
+    idxLst[aliasIdx] = static_cast<uint32_t>(cmdArena.size());
+    appendUnescXML(cmdArena, aliasTable.cmd(aliasIdx));
+    lenLst[aliasIdx] = static_cast<uint32_t>(cmdArena.size() - idxLst[aliasIdx]);
+  }
+
+  //equal commands keep their table order
+  aliasIdxLst.resize(aliasTable.aliasCnt);
+  for (uint32_t aliasIdx = 0; aliasIdx < aliasIdxLst.size(); ++aliasIdx) aliasIdxLst[aliasIdx] = aliasIdx;
+  auto aliasCmd = [&](uint32_t aliasIdx) {
+    return string_view(cmdArena.data() + idxLst[aliasIdx], lenLst[aliasIdx]);
+  };
+  stable_sort(aliasIdxLst.begin(), aliasIdxLst.end(), [&](uint32_t lhs, uint32_t rhs) {
+    return cmpCmd(aliasCmd(lhs), aliasCmd(rhs)) < 0;
+  });
+
+  cmdIdxLst.resize(aliasIdxLst.size());
+  cmdLenLst.resize(aliasIdxLst.size());
+  for (size_t sortedIdx = 0; sortedIdx < aliasIdxLst.size(); ++sortedIdx) {
+    cmdIdxLst[sortedIdx] = idxLst[aliasIdxLst[sortedIdx]];
+    cmdLenLst[sortedIdx] = lenLst[aliasIdxLst[sortedIdx]];
+  }
+}//end CmdPrefixIdx::CmdPrefixIdx
+
+//----------------------------------------------------------------------------
+pair<size_t, size_t> CmdPrefixIdx::findPrefix(string_view prefix) const {
+  //binary search for the first command >= prefix
+  size_t firstIdx = 0, cnt = cmdIdxLst.size();
+  while (cnt > 0) {
+    size_t halfCnt = cnt / 2;
+    if (cmpCmd(cmd(firstIdx + halfCnt), prefix) < 0) {
+      firstIdx += halfCnt + 1;
+      cnt -= halfCnt + 1;
+    }
+    else cnt = halfCnt;
+  }
+  //...and then for the first command past the ones that start with it
+  size_t lastIdx = firstIdx;
+  cnt = cmdIdxLst.size() - firstIdx;
+  while (cnt > 0) {
+    size_t halfCnt = cnt / 2;
+    if (cmdHasPrefix(cmd(lastIdx + halfCnt), prefix)) {
+      lastIdx += halfCnt + 1;
+      cnt -= halfCnt + 1;
+    }
+    else cnt = halfCnt;
+  }
+
+  return { firstIdx, lastIdx };
+}//end CmdPrefixIdx::findPrefix
+
+//----------------------------------------------------------------------------
+int cmpCmd(string_view lhs, string_view rhs) {
+  size_t cmpLen = min(lhs.size(), rhs.size());
+  for (size_t charIdx = 0; charIdx < cmpLen; ++charIdx) {
+    unsigned char lhsChar = foldCase(lhs[charIdx]), rhsChar = foldCase(rhs[charIdx]);
+    if (lhsChar != rhsChar) return (lhsChar < rhsChar) ? -1 : 1;//!!! EXIT FUNCTION HERE !!!//
+  }
+  if (lhs.size() == rhs.size()) return 0;
+
+  return (lhs.size() < rhs.size()) ? -1 : 1;
+}//end cmpCmd
+
+//----------------------------------------------------------------------------
+bool cmdHasPrefix(string_view cmd, string_view prefix) {
+  return cmd.size() >= prefix.size() && CmdEq()(cmd.substr(0, prefix.size()), prefix);
+}//end cmdHasPrefix
+
+//----------------------------------------------------------------------------
+size_t reportAliasShadows(CmdPrefixIdx const& prefixIdx) {
+  size_t shadowCnt = 0;
+  size_t cmdCnt = prefixIdx.cmdIdxLst.size();
+  //LOOP THRU SORTED COMMANDS
+  //  the commands it shadows are all right after it
+  for (size_t sortedIdx = 0; sortedIdx < cmdCnt; ++sortedIdx) {
+    string_view cmd = prefixIdx.cmd(sortedIdx);
+    //duplicates of cmd were reported by the merge... only look at the first
+    if (sortedIdx > 0 && CmdEq()(prefixIdx.cmd(sortedIdx - 1), cmd)) continue; //!!!GO TO NEXT COMMAND!!!//
+    size_t nextIdx = sortedIdx + 1;
+    while (nextIdx < cmdCnt && CmdEq()(prefixIdx.cmd(nextIdx), cmd)) ++nextIdx;
+    if (nextIdx == cmdCnt || !cmdHasPrefix(prefixIdx.cmd(nextIdx), cmd)) continue; //!!!GO TO NEXT COMMAND!!!//
+
+    ++shadowCnt;
+    cout << "Alias \"" << cmd << "\" shadows";
+    for (; nextIdx < cmdCnt && cmdHasPrefix(prefixIdx.cmd(nextIdx), cmd); ++nextIdx)
+      if (!CmdEq()(prefixIdx.cmd(nextIdx), prefixIdx.cmd(nextIdx - 1)))
+        cout << " " << prefixIdx.cmd(nextIdx);
+    cout << endl;
+  }//END LOOP THRU SORTED COMMANDS
+  cout << shadowCnt << " alias(es) shadow longer aliases" << endl;
+
+  return shadowCnt;
+}//end reportAliasShadows
+
+//----------------------------------------------------------------------------
+void runAliasQuery(string const& aliasSrcArg) {
+  if (isAliasStrmArg(aliasSrcArg)) {
+    status_ += NUM_ARGS;
+    prntNExit("--query reads the prefixes from stdin, the VRC aliases must be files");
+  }
+
+  //stdout is only for the results... send the messages of the load to stderr
+  streambuf* coutBuf = cout.rdbuf(cerr.rdbuf());
+  vector<AliasSrc> srcLst = mapAliasSrcs(parseAliasSrcArg(aliasSrcArg));
+  AliasTable aliasTable;
+  loadAliasTable(srcLst, aliasTable);
+  CmdPrefixIdx prefixIdx(aliasTable);
+  if (opts_.shadows) reportAliasShadows(prefixIdx);
+  cout.rdbuf(coutBuf);
+
+  string prefix, rplcmnt;
+  //LOOP THRU PREFIXES OF stdin
+  while (getline(cin, prefix)) {
+    if (!prefix.empty() && prefix.back() == '\r') prefix.pop_back();
+    if (prefix.empty()) continue; //!!!GO TO NEXT LINE!!!//
+
+    pair<size_t, size_t> range = prefixIdx.findPrefix(prefix);
+    for (size_t sortedIdx = range.first; sortedIdx < range.second; ++sortedIdx) {
+      rplcmnt.clear();
+      appendUnescXML(rplcmnt, aliasTable.rplcmnt(prefixIdx.aliasIdxLst[sortedIdx]));
+      cout << prefixIdx.cmd(sortedIdx) << ' ' << rplcmnt << '\n';
+    }
+    cout << '\n';
+  }//END LOOP THRU stdin
+  cout.flush();
+}//end runAliasQuery
+
+//----------------------------------------------------------------------------
+void appendUnescXML(string& str, string_view esc) {
+  string_view static const entityLst[5] = { "&amp;", "&quot;", "&apos;", "&lt;", "&gt;" };
+  char static const charLst[5] = { '&', '"', '\'', '<', '>' };
+  size_t ampIdx = esc.find('&');
+  //LOOP THRU ENTITIES
+  while (ampIdx != string_view::npos) {
+    str += esc.substr(0, ampIdx);
+    esc.remove_prefix(ampIdx);
+    size_t entityIdx = 0;
+    while (entityIdx < 5 && esc.substr(0, entityLst[entityIdx].size()) != entityLst[entityIdx]) ++entityIdx;
+    if (entityIdx < 5) {
+      str += charLst[entityIdx];
+      esc.remove_prefix(entityLst[entityIdx].size());
+    }
+    else {
+      str += '&';
+      esc.remove_prefix(1);
+    }
+    ampIdx = esc.find('&');
+  }//END LOOP THRU ENTITIES
+  str += esc;
+}//end appendUnescXML
+
+//----------------------------------------------------------------------------
+ExpandCtx readExpandCtx(path const& ctxPath) {
+  ExpandCtx ctx;
+  ctx.builtinValLst.resize(size(ALIAS_BUILTIN_LST));
+  InFileBuf ctxFile = openInBuf(ctxPath);
+  if (normalizeInBuf(ctxFile) == TextEnc::UTF16) {
+    status_ += INPUT_ENCODING;
+    prntNExit("UTF-16 input is not supported, save as ANSI or UTF-8: "s + ctxPath.string());
+  }
+
+  string_view buf = ctxFile.view();
+  string_view line;
+  uint32_t lineNum = 0;
+  //LOOP THRU LINES OF CONTEXT FILE
+  while (popLine(buf, line)) {
+    ++lineNum;
+    if (line.empty() || line[0] == ';') continue; //!!!GO TO NEXT LINE!!!//
+    size_t eqIdx = line.find('=');
+    if (eqIdx == string_view::npos || eqIdx == 0) {
+      status_ += CONFIG_FORMAT;
+      prntNExit("Expected name=value at " + ctxPath.string() + ":" + to_string(lineNum));
+    }
+
+    string_view name = line.substr(0, eqIdx);
+    if (name[0] == '$') name.remove_prefix(1);
+    string key;
+    for (char chr : name) key += static_cast<char>(foldCase(chr));
+    string val(line.substr(eqIdx + 1));
+    if (key.find('(') != string::npos) {
+      ctx.funcValLst[key] = move(val);
+      continue; //!!!GO TO NEXT LINE!!!//
+    }
+    AliasBuiltin const* builtin = findAliasBuiltin(key);
+    if (builtin != nullptr && !builtin->isFunc) ctx.builtinValLst[builtin - ALIAS_BUILTIN_LST] = move(val);
+    else ctx.varValLst[key] = move(val);
+  }//END LOOP THRU CONTEXT FILE
+
+  return ctx;
+}//end readExpandCtx
+
+//----------------------------------------------------------------------------
+void runAliasExpand(string const& aliasSrcArg) {
+  if (isAliasStrmArg(aliasSrcArg)) {
+    status_ += NUM_ARGS;
+    prntNExit("--expand reads the commands from stdin, the VRC aliases must be files");
+  }
+  ExpandCtx ctx = readExpandCtx(opts_.expandCtxPath);
+
+  //stdout is only for the expansions, so they can be diffed...
+  //  send the messages of the load to stderr
+  streambuf* coutBuf = cout.rdbuf(cerr.rdbuf());
+  vector<AliasSrc> srcLst = mapAliasSrcs(parseAliasSrcArg(aliasSrcArg));
+  AliasTable aliasTable;
+  loadAliasTable(srcLst, aliasTable);
+  AliasEngine aliasEngine(aliasTable);
+  if (opts_.shadows) reportAliasShadows(CmdPrefixIdx(aliasTable));
+  cout.rdbuf(coutBuf);
+
+  string cmdLine, expansion;
+  size_t cmdCnt = 0, unknownCnt = 0;
+  //LOOP THRU COMMAND LINES OF stdin
+  while (getline(cin, cmdLine)) {
+    if (!cmdLine.empty() && cmdLine.back() == '\r') cmdLine.pop_back();
+    if (cmdLine.empty()) continue; //!!!GO TO NEXT LINE!!!//
+    ++cmdCnt;
+    if (aliasEngine.expand(cmdLine, ctx, expansion)) cout << expansion << '\n';
+    else {
+      ++unknownCnt;
+      cerr << "Warning: no alias for: " << cmdLine << endl;
+      cout << cmdLine << '\n';
+    }
+  }//END LOOP THRU stdin
+  cout.flush();
+
+  cerr << "Expanded " << cmdCnt - unknownCnt << " of " << cmdCnt << " command(s)" << endl;
+}//end runAliasExpand
+
+
+//----------------------------------------------------------------------------
+void loadAliasTable(vector<AliasSrc>& srcLst, AliasTable& aliasTable) {
+  path cachePath = getAliasCachePath(srcLst);
+  if (opts_.useCache && readAliasCache(cachePath, srcLst, aliasTable)) {
+    cout << "Using cached VRC aliases: " << cachePath.string() << endl;
+    reportAliasLint(aliasTable.lintCnt);
+    reportAliasMerge(aliasTable.dupCnt, aliasTable.overrideCnt);
+  }
+  else {
+    scanAliasSrcs(srcLst);
+    buildAliasTable(srcLst, aliasTable);
+    mergeAliasTable(srcLst, aliasTable);
+    if (opts_.useCache) writeAliasCache(cachePath, srcLst, aliasTable);
+  }//end if cache hit ... else
+
+  reportAliasGraph(aliasTable);
+}//end loadAliasTable
+
+//----------------------------------------------------------------------------
+path getAliasCachePath(vector<AliasSrc> const& srcLst) {
+  path cachePath = srcLst.front().srcPath;
+  cachePath += ALIAS_CACHE_EXT;
+  return cachePath;
+}//end getAliasCachePath
+
+//----------------------------------------------------------------------------
+bool readAliasCache(
+  path const& cachePath, vector<AliasSrc> const& srcLst, AliasTable& aliasTable
+) {
+  error_code err;
+  if (!filesystem::is_regular_file(cachePath, err)) return false;//!!! EXIT FUNCTION HERE !!!//
+  InFileBuf cacheBuf;
+  if (!readInBuf(cachePath, cacheBuf)) return false;//!!! EXIT FUNCTION HERE !!!//
+  string_view cache = cacheBuf.view();
+
+  //check the header... anything unexpected means stale or corrupt
+  if (cache.size() < sizeof(AliasCacheHdr)) return false;//!!! EXIT FUNCTION HERE !!!//
+  AliasCacheHdr const* hdr = reinterpret_cast<AliasCacheHdr const*>(cache.data());
+  uint32_t flags = (opts_.dropDups ? ALIAS_CACHE_DROP_DUPS : 0) | (opts_.lint ? ALIAS_CACHE_LINT : 0);
+  if (memcmp(hdr->magic, ALIAS_CACHE_MAGIC, sizeof(hdr->magic)) != 0
+      || hdr->version != ALIAS_CACHE_VERSION || hdr->flags != flags
+      || hdr->srcCnt != srcLst.size())
+    return false;//!!! EXIT FUNCTION HERE !!!//
+  uint64_t expectedLen = sizeof(AliasCacheHdr) + uint64_t(hdr->srcCnt) * sizeof(AliasCacheSrc)
+    + uint64_t(hdr->aliasCnt) * 4 * sizeof(uint32_t) + hdr->arenaLen;
+  if (cache.size() != expectedLen
+      || hashBytes(cache.substr(sizeof(AliasCacheHdr))) != hdr->payloadHash)
+    return false;//!!! EXIT FUNCTION HERE !!!//
+
+  //check it was built from exactly these sources
+  AliasCacheSrc const* cacheSrcLst = reinterpret_cast<AliasCacheSrc const*>(hdr + 1);
+  for (size_t srcIdx = 0; srcIdx < srcLst.size(); ++srcIdx) {
+    if (cacheSrcLst[srcIdx].rawSize != srcLst[srcIdx].rawSize
+        || cacheSrcLst[srcIdx].rawHash != srcLst[srcIdx].rawHash)
+      return false;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  uint32_t const* colLst = reinterpret_cast<uint32_t const*>(cacheSrcLst + hdr->srcCnt);
+  size_t aliasCnt = hdr->aliasCnt;
+  aliasTable.aliasCnt = aliasCnt;
+  aliasTable.cmdIdxLst = colLst;
+  aliasTable.cmdLenLst = colLst + aliasCnt;
+  aliasTable.rplcmntIdxLst = colLst + 2 * aliasCnt;
+  aliasTable.rplcmntLenLst = colLst + 3 * aliasCnt;
+  aliasTable.arena = reinterpret_cast<char const*>(colLst + 4 * aliasCnt);
+  aliasTable.arenaLen = static_cast<size_t>(hdr->arenaLen);
+  for (size_t aliasIdx = 0; aliasIdx < aliasCnt; ++aliasIdx) {
+    if (uint64_t(aliasTable.cmdIdxLst[aliasIdx]) + aliasTable.cmdLenLst[aliasIdx] > hdr->arenaLen
+        || uint64_t(aliasTable.rplcmntIdxLst[aliasIdx]) + aliasTable.rplcmntLenLst[aliasIdx] > hdr->arenaLen) {
+      aliasTable = AliasTable();
+      return false;//!!! EXIT FUNCTION HERE !!!//
+    }
+  }
+
+  aliasTable.dupCnt = hdr->dupCnt;
+  aliasTable.overrideCnt = hdr->overrideCnt;
+  aliasTable.lintCnt = hdr->lintCnt;
+  aliasTable.cacheBuf = move(cacheBuf);
+
+  return true;
+}//end readAliasCache
+
+//----------------------------------------------------------------------------
+void writeAliasCache(
+  path const& cachePath, vector<AliasSrc> const& srcLst, AliasTable const& aliasTable
+) {
+  AliasCacheHdr hdr = {};
+  memcpy(hdr.magic, ALIAS_CACHE_MAGIC, sizeof(hdr.magic));
+  hdr.version = ALIAS_CACHE_VERSION;
+  hdr.flags = (opts_.dropDups ? ALIAS_CACHE_DROP_DUPS : 0) | (opts_.lint ? ALIAS_CACHE_LINT : 0);
+  hdr.srcCnt = static_cast<uint32_t>(srcLst.size());
+  hdr.aliasCnt = static_cast<uint32_t>(aliasTable.aliasCnt);
+  hdr.dupCnt = aliasTable.dupCnt;
+  hdr.overrideCnt = aliasTable.overrideCnt;
+  hdr.lintCnt = aliasTable.lintCnt;
+  hdr.arenaLen = aliasTable.arenaLen;
+
+  string payload;
+  for (AliasSrc const& src : srcLst) {
+    AliasCacheSrc cacheSrc = { src.rawSize, src.rawHash };
+    payload.append(reinterpret_cast<char const*>(&cacheSrc), sizeof(cacheSrc));
+  }
+  size_t colLen = aliasTable.aliasCnt * sizeof(uint32_t);
+  payload.append(reinterpret_cast<char const*>(aliasTable.cmdIdxLst), colLen);
+  payload.append(reinterpret_cast<char const*>(aliasTable.cmdLenLst), colLen);
+  payload.append(reinterpret_cast<char const*>(aliasTable.rplcmntIdxLst), colLen);
+  payload.append(reinterpret_cast<char const*>(aliasTable.rplcmntLenLst), colLen);
+  payload.append(aliasTable.arena, aliasTable.arenaLen);
+  hdr.payloadHash = hashBytes(payload);
+
+  //write next to it and rename, so no one ever maps half a cache
+  path tmpPath = cachePath;
+  tmpPath += ".tmp";
+  {
+    ofstream cacheStrm(tmpPath, ios_base::out | ios_base::trunc | ios_base::binary);
+    cacheStrm.write(reinterpret_cast<char const*>(&hdr), sizeof(hdr));
+    cacheStrm.write(payload.data(), static_cast<streamsize>(payload.size()));
+    if (!cacheStrm) {
+      cacheStrm.close();
+      error_code err;
+      filesystem::remove(tmpPath, err);
+      cerr << "Warning: Could not write alias cache: " << cachePath.string() << "... continuing..." << endl;
+      return;//!!! EXIT FUNCTION HERE !!!//
+    }
+  }//end write cacheStrm
+  error_code err;
+  filesystem::rename(tmpPath, cachePath, err);
+  if (err) {
+    filesystem::remove(tmpPath, err);
+    cerr << "Warning: Could not write alias cache: " << cachePath.string() << "... continuing..." << endl;
+  }
+}//end writeAliasCache
+
+//----------------------------------------------------------------------------
+void appendAliasLineXML(
+  string& out, string_view vrcAliasBuf, AliasLineIdx const& aliasLineIdx
+) {
+  appendXMLElem(
+    out, getCommandAliasFmt(),
+    getAliasCmd(vrcAliasBuf, aliasLineIdx), getAliasRplcmnt(vrcAliasBuf, aliasLineIdx)
+  );
+}//end appendAliasLineXML
+
+//----------------------------------------------------------------------------
+size_t getAliasRangeXMLLen(
+  AliasTable const& aliasTable, size_t firstIdx, size_t lastIdx
+) {
+  size_t rangeLen = (lastIdx - firstIdx) * (1 + getCommandAliasFmt().fixedLen());
+  for (size_t aliasIdx = firstIdx; aliasIdx < lastIdx; ++aliasIdx)
+    rangeLen += aliasTable.cmdLenLst[aliasIdx] + aliasTable.rplcmntLenLst[aliasIdx];
+  return rangeLen;
+}//end getAliasRangeXMLLen
+
+//----------------------------------------------------------------------------
+char* writeAliasRangeXML(
+  char* outPos, AliasTable const& aliasTable, size_t firstIdx, size_t lastIdx
+) {
+  XMLElemFmt<2> const& aliasFmt = getCommandAliasFmt();
+  //LOOP THRU ALIASES OF THIS RANGE
+  for (size_t aliasIdx = firstIdx; aliasIdx < lastIdx; ++aliasIdx) {
+    //the table is already escaped
+    *outPos++ = '\n';
+    outPos = writeXMLElem(
+      outPos, aliasFmt,
+      XMLRaw{ aliasTable.cmd(aliasIdx) }, XMLRaw{ aliasTable.rplcmnt(aliasIdx) }
+    );
+  }//END LOOP THRU ALIASES OF THIS RANGE
+
+  return outPos;
+}//end writeAliasRangeXML
+
+//----------------------------------------------------------------------------
+string cnvrtVRCalias2XML(vector<AliasSrc>& srcLst) {
+  AliasTable aliasTable;
+  loadAliasTable(srcLst, aliasTable);
+  if (opts_.shadows) reportAliasShadows(CmdPrefixIdx(aliasTable));
+
+  string const blockHead = getBlockIndent() + "<CommandAliases>";
+  //<CommandAliasesLastImported>2021-03-24T19:26:55.1456232-04:00</CommandAliasesLastImported>
+  string const blockTail = "\n" + getBlockIndent() + "</CommandAliases>"
+    "\n" + getBlockIndent() + "<CommandAliasesLastImported>" + getUpdateTimeStr() + "</CommandAliasesLastImported>";
+
+  size_t chunkCnt = 4 * max(1u, thread::hardware_concurrency());
+  chunkCnt = min(chunkCnt, aliasTable.aliasCnt / MIN_CHUNK_ALIASES + 1);
+  auto getFirstIdx = [&](size_t chunkIdx) { return aliasTable.aliasCnt * chunkIdx / chunkCnt; };
+  //measure... chunkOffsetLst[chunkIdx + 1] is the length of the chunk
+  //  until the lengths are summed into offsets
+  vector<size_t> chunkOffsetLst(chunkCnt + 1);
+  runTasks(chunkCnt, [&](size_t chunkIdx) {
+    chunkOffsetLst[chunkIdx + 1] = getAliasRangeXMLLen(
+      aliasTable, getFirstIdx(chunkIdx), getFirstIdx(chunkIdx + 1)
+    );
+  });
+  chunkOffsetLst[0] = blockHead.size();
+  for (size_t chunkIdx = 1; chunkIdx <= chunkCnt; ++chunkIdx)
+    chunkOffsetLst[chunkIdx] += chunkOffsetLst[chunkIdx - 1];
+
+  //...then write, each chunk in its own place
+  string cmdAliasesXML;
+  cmdAliasesXML.resize(chunkOffsetLst[chunkCnt] + blockTail.size());
+  char* blockBuf = cmdAliasesXML.data();
+  copy(blockHead.begin(), blockHead.end(), blockBuf);
+  runTasks(chunkCnt, [&](size_t chunkIdx) {
+    writeAliasRangeXML(
+      blockBuf + chunkOffsetLst[chunkIdx],
+      aliasTable, getFirstIdx(chunkIdx), getFirstIdx(chunkIdx + 1)
+    );
+  });
+  copy(blockTail.begin(), blockTail.end(), blockBuf + chunkOffsetLst[chunkCnt]);
+
+  return cmdAliasesXML;
+}//end cnvrtVRCalias2XML
+
+//----------------------------------------------------------------------------
+string cnvrtVRCaliasStrm2XML(LineStrmReader& vrcAliasStrm) {
+  if (opts_.dropDups)
+    cout << "Note: --drop-dups does not apply to streamed VRC aliases" << endl;
+
+  string_view aliasLine;
+  string utf8Line;
+  vector<AliasTok> tokLst;
+  string lintMsgs;
+  uint32_t lintCnt = 0;
+  string cmdAliasesXML = getBlockIndent() + "<CommandAliases>";
+  //LOOP THRU LINES OF VRC ALIAS STREAM
+  while (vrcAliasStrm.nextLine(aliasLine)) {
+    if (vrcAliasStrm.lineNum == 1) {
+      if (aliasLine.substr(0, 2) == "\xFF\xFE" || aliasLine.substr(0, 2) == "\xFE\xFF") {
+        status_ += INPUT_ENCODING;
+        prntNExit("UTF-16 input is not supported, save as ANSI or UTF-8");
+      }
+      if (aliasLine.substr(0, 3) == "\xEF\xBB\xBF") aliasLine.remove_prefix(3);
+    }//end if first line
+    if (aliasLine.empty() || aliasLine[0] != '.') continue; //!!!GO TO NEXT LINE!!!//
+
+    size_t highIdx = findHighByte(aliasLine);
+    if (highIdx < aliasLine.size() && !isUTF8(aliasLine, highIdx)) {
+      utf8Line = cp1252ToUTF8(aliasLine, highIdx);
+      aliasLine = utf8Line;
+    }
+    AliasLineIdx aliasLineIdx;
+    aliasLineIdx.lineLen = static_cast<uint32_t>(aliasLine.size());
+    size_t splitIdx = aliasLine.find(' ');
+    aliasLineIdx.splitLen = (splitIdx == string_view::npos) ? NO_SPLIT : static_cast<uint32_t>(splitIdx);
+    aliasLineIdx.lineNum = vrcAliasStrm.lineNum;
+    if (opts_.lint) {
+      lintCnt += lintAliasBody(
+        getAliasCmd(aliasLine, aliasLineIdx), getAliasRplcmnt(aliasLine, aliasLineIdx),
+        aliasLineIdx.splitLen != NO_SPLIT, "", aliasLineIdx.lineNum,
+        tokLst, lintMsgs
+      );
+      cerr << lintMsgs;
+      lintMsgs.clear();
+    }
+    cmdAliasesXML += '\n';
+    appendAliasLineXML(cmdAliasesXML, aliasLine, aliasLineIdx);
+  }//END LOOP THRU VRC ALIAS STREAM
+
+  if (vrcAliasStrm.lineTooLong) {
+    status_ += INPUT_LINE_LEN;
+    prntNExit("VRC alias line " + to_string(vrcAliasStrm.lineNum + 1) + " is longer than "
+      + to_string(STRM_BUF_LEN) + " bytes");
+  }
+  if (ferror(vrcAliasStrm.strm)) {
+    status_ += OPEN_FILE_FAILURE;
+    prntNExit("Error while reading VRC alias stream");
+  }
+  reportAliasLint(lintCnt);
+  cmdAliasesXML += "\n" + getBlockIndent() + "</CommandAliases>";
+  //<CommandAliasesLastImported>2021-03-24T19:26:55.1456232-04:00</CommandAliasesLastImported>
+  cmdAliasesXML += "\n" + getBlockIndent() + "<CommandAliasesLastImported>"+getUpdateTimeStr()+"</CommandAliasesLastImported>";
+
+  return cmdAliasesXML;
+}//end cnvrtVRCaliasStrm2XML
+
+//----------------------------------------------------------------------------
+XMLStrPool::XMLStrPool() {
+  slotLst.assign(64, NO_HANDLE);
+  slotMask = slotLst.size() - 1;
+}//end XMLStrPool::XMLStrPool
+
+//----------------------------------------------------------------------------
+uint32_t XMLStrPool::intern(string_view str) {
+  uint32_t strHash = static_cast<uint32_t>(hash<string_view>()(str));
+  size_t slotIdx = strHash & slotMask;
+  //LOOP THRU PROBE SEQUENCE
+  for (; slotLst[slotIdx] != NO_HANDLE; slotIdx = (slotIdx + 1) & slotMask) {
+    uint32_t handle = slotLst[slotIdx];
+    if (hashLst[handle] == strHash && keyLst[handle] == str) return handle;//!!! EXIT FUNCTION HERE !!!//
+  }//END LOOP THRU PROBE SEQUENCE
+
+  uint32_t handle = static_cast<uint32_t>(keyLst.size());
+  slotLst[slotIdx] = handle;
+  keyLst.push_back(str);
+  hashLst.push_back(strHash);
+  strIdxLst.push_back(static_cast<uint32_t>(arena.size()));
+  appendEscXML(arena, str);
+  strLenLst.push_back(static_cast<uint32_t>(arena.size() - strIdxLst.back()));
+
+  //keep the load factor at or under 1/2
+  if (2 * keyLst.size() > slotLst.size()) {
+    slotLst.assign(2 * slotLst.size(), NO_HANDLE);
+    slotMask = slotLst.size() - 1;
+    //LOOP THRU HANDLES TO REHASH THEM
+    for (uint32_t rehashHandle = 0; rehashHandle < keyLst.size(); ++rehashHandle) {
+      size_t rehashIdx = hashLst[rehashHandle] & slotMask;
+      while (slotLst[rehashIdx] != NO_HANDLE) rehashIdx = (rehashIdx + 1) & slotMask;
+      slotLst[rehashIdx] = rehashHandle;
+    }//END LOOP THRU HANDLES TO REHASH THEM
+  }
+  return handle;
+}//end XMLStrPool::intern
+
+//----------------------------------------------------------------------------
+Position initPosition(string_view positionLine, XMLStrPool& strPool) {
+  Position pos;
+  string_view radioName, freqField, sectorID, posSymField, prefix, suffix;
+  popField(positionLine, pos.sectorName, ':');
+  popField(positionLine, radioName, ':');
+  popField(positionLine, freqField, ':');
+  popField(positionLine, sectorID, ':');
+  popField(positionLine, posSymField, ':');
+  popField(positionLine, prefix, ':');
+  popField(positionLine, suffix, ':');
+
+  if (!parseFreq(freqField, pos.freq)) {
+    pos.freq = NO_FREQ;
+    pos.isFreqOK = false;
+  }
+
+  //the position symbol is the first char that is not white space
+  while (!posSymField.empty() && isspace(static_cast<unsigned char>(posSymField[0])))
+    posSymField.remove_prefix(1);
+  if (!posSymField.empty()) pos.posSym = posSymField[0];
+
+  pos.positionType = cfg_.classify(sectorID);
+  pos.radioName = strPool.intern(radioName);
+  pos.prefix = strPool.intern(prefix);
+  pos.suffix = strPool.intern(suffix);
+  pos.sectorID = strPool.intern(sectorID);
+
+  return pos;
+}//end initPosition
+
+//----------------------------------------------------------------------------
+void appendPositionXML(string& out, Position const& pos, XMLStrPool const& strPool) {
+  array<char, FREQ_STR_LEN> freqBuf;
+  appendXMLElem(
+    out, getPositionInfoFmt(),
+    XMLRaw{ SECTOR_CLASS_NAME_LST[static_cast<size_t>(pos.positionType)] }, pos.sectorName,
+    XMLRaw{ strPool.str(pos.radioName) }, XMLRaw{ strPool.str(pos.prefix) },
+    XMLRaw{ strPool.str(pos.suffix) }, XMLRaw{ fmtFreq(pos.freq, freqBuf) },
+    XMLRaw{ strPool.str(pos.sectorID) }, pos.posSym
+  );
+}//end appendPositionXML
+
+//----------------------------------------------------------------------------
+size_t getPositionXMLLen(Position const& pos, XMLStrPool const& strPool) {
+  array<char, FREQ_STR_LEN> freqBuf;
+  return getXMLElemLen(
+    getPositionInfoFmt(),
+    XMLRaw{ SECTOR_CLASS_NAME_LST[static_cast<size_t>(pos.positionType)] }, pos.sectorName,
+    XMLRaw{ strPool.str(pos.radioName) }, XMLRaw{ strPool.str(pos.prefix) },
+    XMLRaw{ strPool.str(pos.suffix) }, XMLRaw{ fmtFreq(pos.freq, freqBuf) },
+    XMLRaw{ strPool.str(pos.sectorID) }, pos.posSym
+  );
+}//end getPositionXMLLen
+
+//----------------------------------------------------------------------------
+bool parseFreq(string_view field, int32_t& freq) {
+  while (!field.empty() && isspace(static_cast<unsigned char>(field[0]))) field.remove_prefix(1);
+  bool isNeg = !field.empty() && field[0] == '-';
+  if (!field.empty() && (field[0] == '-' || field[0] == '+')) field.remove_prefix(1);
+
+  //whole MHz... may be left out, as in .5
+  uint32_t mhz = 0;
+  char const* fieldEnd = field.data() + field.size();
+  from_chars_result mhzRslt = from_chars(field.data(), fieldEnd, mhz);
+  char const* numEnd = mhzRslt.ptr;
+  bool hasDigits = (numEnd != field.data());
+  //kHz have to fit in an int32_t
+  if (mhzRslt.ec == errc::result_out_of_range || mhz > 2000000) return false;//!!! EXIT FUNCTION HERE !!!//
+
+  //kHz are the first 3 decimals, any more have to be 0
+  uint32_t khz = mhz * 1000;
+  if (numEnd != fieldEnd && *numEnd == '.') {
+    uint32_t const placeValLst[3] = { 100, 10, 1 };
+    size_t decimalCnt = 0;
+    //LOOP THRU DECIMALS
+    for (++numEnd; numEnd != fieldEnd && *numEnd >= '0' && *numEnd <= '9'; ++numEnd, ++decimalCnt) {
+      hasDigits = true;
+      uint32_t digit = static_cast<uint32_t>(*numEnd - '0');
+      if (decimalCnt < 3) khz += digit * placeValLst[decimalCnt];
+      else if (digit != 0) return false;//!!! EXIT FUNCTION HERE !!!//
+    }//END LOOP THRU DECIMALS
+  }
+  if (!hasDigits) return false;//!!! EXIT FUNCTION HERE !!!//
+
+  freq = (isNeg ? -static_cast<int32_t>(khz) : static_cast<int32_t>(khz)) - 100000;
+  return true;
+}//end parseFreq
+
+//----------------------------------------------------------------------------
+string_view fmtFreq(int32_t freq, array<char, FREQ_STR_LEN>& freqBuf) {
+  char* bufEnd = freqBuf.data() + freqBuf.size();
+  char* outPos = bufEnd - 7;
+  memcpy(outPos, ".000000", 7);
+
+  uint32_t mag = (freq < 0) ? 0u - static_cast<uint32_t>(freq) : static_cast<uint32_t>(freq);
+  //LOOP THRU DIGIT PAIRS, LOWEST FIRST
+  for (; mag >= 100; mag /= 100) {
+    outPos -= 2;
+    memcpy(outPos, &DIGIT_PAIR_LST[(mag % 100) * 2], 2);
+  }//END LOOP THRU DIGIT PAIRS
+  if (mag >= 10) {
+    outPos -= 2;
+    memcpy(outPos, &DIGIT_PAIR_LST[mag * 2], 2);
+  }
+  else *--outPos = static_cast<char>('0' + mag);
+  if (freq < 0) *--outPos = '-';
+
+  return string_view(outPos, bufEnd - outPos);
+}//end fmtFreq
+
+//----------------------------------------------------------------------------
+string cnvrtVRCpof2XML(string_view vrcPofBuf) {
+  string const blockHead = getBlockIndent() + "<Positions>";
+  string const blockTail = "\n" + getBlockIndent() + "</Positions>";
+  auto isPositionLine = [](string_view line) { return !line.empty() && line[0] != ';'; };
+
+  XMLStrPool strPool;
+  vector<Position> posLst;
+  string_view pofBuf = vrcPofBuf, positionLine;
+  uint32_t lineNum = 0, badFreqCnt = 0;
+  //LOOP THRU LINES OF VRC POF FILE
+  while (popLine(pofBuf, positionLine)) {
+    ++lineNum;
+    if (!isPositionLine(positionLine)) continue; //!!!GO TO NEXT LINE!!!//
+    posLst.push_back(initPosition(positionLine, strPool));
+    if (!posLst.back().isFreqOK) {
+      ++badFreqCnt;
+      cerr << "Warning: position \"" << posLst.back().sectorName << "\" at line " << lineNum
+           << ": the frequency is not in MHz to the kHz (e.g. 124.350)" << endl;
+    }
+  }//END LOOP THRU VRC POF FILE
+  if (badFreqCnt != 0) {
+    status_ += POF_FREQ;
+    cerr << "Warning: " << badFreqCnt << " position(s) with a bad frequency, written as "
+         << NO_FREQ << ".000000" << endl;
+  }
+
+  size_t blockLen = blockHead.size() + blockTail.size();
+  for (Position const& pos : posLst) blockLen += 1 + getPositionXMLLen(pos, strPool);
+
+  string positionsXML;
+  positionsXML.reserve(blockLen);
+  positionsXML += blockHead;
+  //LOOP THRU POSITIONS
+  for (Position const& pos : posLst) {
+    positionsXML += '\n';
+    appendPositionXML(positionsXML, pos, strPool);
+  }//END LOOP THRU POSITIONS
+  positionsXML += blockTail;
+
+  return positionsXML;
+}//end cnvrtVRCpof2XML
+
+//----------------------------------------------------------------------------
+void runTasks(size_t taskCnt, function<void(size_t)> const& taskFn) {
+  if (taskCnt <= 1 || thread::hardware_concurrency() <= 1) {
+    for (size_t taskIdx = 0; taskIdx < taskCnt; ++taskIdx) taskFn(taskIdx);
+    return;//!!! EXIT FUNCTION HERE !!!//
+  }
+  workerPool_.run(taskCnt, taskFn);
+}//end runTasks
+
+//----------------------------------------------------------------------------
+WorkerPool::~WorkerPool() {
+  {
+    lock_guard<mutex> batchLock(batchMutex);
+    stop = true;
+  }
+  batchCond.notify_all();
+  for (thread& thrd : thrdLst) thrd.join();
+}//end WorkerPool::~WorkerPool
+
+//----------------------------------------------------------------------------
+void WorkerPool::run(size_t newTaskCnt, function<void(size_t)> const& newTaskFn) {
+  //this thread works too, so start one less
+  if (thrdLst.empty()) {
+    size_t thrdCnt = max(2u, thread::hardware_concurrency()) - 1;
+    thrdLst.reserve(thrdCnt);
+    for (size_t thrdIdx = 0; thrdIdx < thrdCnt; ++thrdIdx)
+      thrdLst.emplace_back(&WorkerPool::work, this);
+  }
+
+  {
+    lock_guard<mutex> batchLock(batchMutex);
+    taskFn = &newTaskFn;
+    taskCnt = newTaskCnt;
+    nextTaskIdx = 0;
+    doneCnt = 0;
+    ++batchNum;
+  }
+  batchCond.notify_all();
+
+  size_t taskIdx;
+  while ((taskIdx = nextTaskIdx.fetch_add(1)) < newTaskCnt) newTaskFn(taskIdx);
+
+  unique_lock<mutex> batchLock(batchMutex);
+  doneCond.wait(batchLock, [this]() { return doneCnt == thrdLst.size(); });
+  taskFn = nullptr;
+}//end WorkerPool::run
+
+//----------------------------------------------------------------------------
+void WorkerPool::work() {
+  uint64_t doneBatchNum = 0;
+  unique_lock<mutex> batchLock(batchMutex);
+  //LOOP THRU BATCHES
+  while (true) {
+    batchCond.wait(batchLock, [&]() { return stop || batchNum != doneBatchNum; });
+    if (stop) return;//!!! EXIT FUNCTION HERE !!!//
+    doneBatchNum = batchNum;
+    function<void(size_t)> const& batchTaskFn = *taskFn;
+    size_t batchTaskCnt = taskCnt;
+    batchLock.unlock();
+
+    size_t taskIdx;
+    while ((taskIdx = nextTaskIdx.fetch_add(1)) < batchTaskCnt) batchTaskFn(taskIdx);
+
+    batchLock.lock();
+    if (++doneCnt == thrdLst.size()) doneCond.notify_one();
+  }//END LOOP THRU BATCHES
+}//end WorkerPool::work
+
+//----------------------------------------------------------------------------
+vector<string_view> splitAtLines(string_view buf, size_t chunkCnt) {
+  vector<string_view> chunkLst;
+  if (chunkCnt == 0) chunkCnt = 1;
+  chunkLst.reserve(chunkCnt);
+
+  size_t chunkIdx = 0;
+  //LOOP THRU CHUNK BOUNDARIES
+  for (size_t chunkNum = 1; chunkNum < chunkCnt && chunkIdx < buf.size(); ++chunkNum) {
+    size_t chunkEnd = buf.size() / chunkCnt * chunkNum;
+    if (chunkEnd < chunkIdx) continue; //!!!GO TO NEXT BOUNDARY!!!//
+    chunkEnd = buf.find('\n', chunkEnd);
+    if (chunkEnd == string_view::npos) break;
+    ++chunkEnd;
+    chunkLst.push_back(buf.substr(chunkIdx, chunkEnd - chunkIdx));
+    chunkIdx = chunkEnd;
+  }//END LOOP THRU CHUNK BOUNDARIES
+  if (chunkIdx < buf.size() || chunkLst.empty())
+    chunkLst.push_back(buf.substr(chunkIdx));
+
+  return chunkLst;
+}//end splitAtLines
+
+//----------------------------------------------------------------------------
+void gzipFile(path const& filePath){
+  //try compress
+  try {
+    BitCompressor bit7zCompressor(Bit7zLibrary(), ::bit7z::BitFormat::GZip);
+
+    path newGZipFacilityPath = filePath.wstring() + L".gz";
+    verifyNDelFilePath(newGZipFacilityPath);
+
+    bit7zCompressor.compressFile(
+      filePath.wstring(),
+      newGZipFacilityPath
+    );
+  }//end try
+  catch (const BitException& err) {
+    //do something with err.what()
+    cerr << err.what() << endl;
+    status_ += GZIP_COMPRESS_ERROR;
+    cleanNExit();
+  }//edn try compress / catch
+}//end gzipFile
+
+//----------------------------------------------------------------------------
+void gzipStrm(istream& in, path& filePath) {
+  //try compress
+  try {
+    Bit7zLibrary lib;
+    BitStreamCompressor bit7zCompressor(lib, ::bit7z::BitFormat::GZip);
+    verifyNDelFilePath(filePath);
+
+    bit7zCompressor.compress(
+      in,
+      filePath
+    );
+  }//end try
+  catch (const BitException& err) {
+    //do something with err.what()
+    cerr << err.what() << endl;
+    status_ += GZIP_COMPRESS_ERROR;
+    cleanNExit();
+  }//edn try compress / catch
+}//end gzipFile
+
+//----------------------------------------------------------------------------
+stringstream ungzip2Strm(path const& filePath) {
+  stringstream fileStrm;
+
+  //try extract
+  try {
+    Bit7zLibrary lib;
+    BitExtractor bit7zExtractor(lib, ::bit7z::BitFormat::GZip);
+    
     bit7zExtractor.extract(filePath.wstring(), fileStrm);
   }//end try
   catch (const BitException& err) {
@@ -711,6 +4576,30 @@ stringstream ungzip2Strm(path const& filePath) {
   return fileStrm;
 }//end ungzip2Strm
 
+//----------------------------------------------------------------------------
+void validateFacilityXML(SpanLst const& facilityDoc, path const& facilityFilePath) {
+  XMLValidator validator;
+  bool isValid = true;
+  for (string_view span : facilityDoc.spanLst)
+    if (!(isValid = validator.feed(span))) break;
+  if (isValid && validator.finish()) return;//!!! EXIT FUNCTION HERE !!!//
+
+  //the line is only worked out once there is an error
+  size_t lineNum = 1, spanStart = 0;
+  //LOOP THRU SPANS BEFORE THE ERROR
+  for (string_view span : facilityDoc.spanLst) {
+    if (spanStart >= validator.errPos) break;
+    span = span.substr(0, validator.errPos - spanStart);
+    lineNum += count(span.begin(), span.end(), '\n');
+    spanStart += span.size();
+  }//END LOOP THRU SPANS BEFORE THE ERROR
+
+  status_ += FACILITY_FILE_FORMAT;
+  prntNExit("Error updating facility file: "s + facilityFilePath.string()
+    + "\nNew facility file would not be well-formed XML (line " + to_string(lineNum) + "): "
+    + validator.errMsg);
+}//end validateFacilityXML
+
 //----------------------------------------------------------------------------
 //depracated
 void addCmds2Facilities(
@@ -756,26 +4645,33 @@ void addCmds2Facilities(
 
 //----------------------------------------------------------------------------
 void updateFacilityFiles(
-  string const& cmdBlock, string const& posBlock,
+  string cmdBlock, string posBlock,
   int const& numArgs, char** const& argLst
 ) {
-  string facilityLine;
+  string_view const newLine = "\n";
   bool orig = true, /*force = false,*/ firstDone = false;
   InfoType type = InfoType::NONE;
   //LOOP THRU ADD <CommandAliases>...</CommandAliases> TO EACH FACILITY FILE
   //actually increments facilityIdx += 2 on ea iteration
-  for (int facilityIdx = FACILITY_IDX; facilityIdx < numArgs; ++facilityIdx) {
+  for (int facilityIdx = getFacilityIdx(numArgs); facilityIdx < numArgs; ++facilityIdx) {
     orig = true;
     firstDone = false;
     //get input file
     path facilityFilePath(argLst[facilityIdx++]);
-    stringstream origFacilityFile = ungzip2Strm(facilityFilePath);
+    //the rvalue str() moves the text out of the stream, it is not copied
+    string const origFacilityBuf = ungzip2Strm(facilityFilePath).str();
     //ofstream newFacilityFile = openOutStrm(newFacilityFilePath, force);
-    stringstream newFacilityFile;
+    SpanLst newFacilityFile;
 
+    size_t lineIdx = 0;
     //LOOP THRU LINES OF THIS FACILITY FILE
-    while (getline(origFacilityFile, facilityLine)) {
-      if (facilityLine.find("<CommandAliases>") != string::npos) {
+    //  (split at \n only, like getline, so a \r stays part of its line)
+    while (lineIdx < origFacilityBuf.size()) {
+      size_t lineEnd = min(origFacilityBuf.find('\n', lineIdx), origFacilityBuf.size());
+      string_view facilityLine(origFacilityBuf.data() + lineIdx, lineEnd - lineIdx);
+      lineIdx = lineEnd + 1;
+
+      if (facilityLine.find("<CommandAliases>") != string_view::npos) {
         //check for bad format
         if (type != InfoType::NONE) {
           status_ += FACILITY_FILE_FORMAT;
@@ -786,8 +4682,8 @@ void updateFacilityFiles(
         orig = false;
         type = InfoType::CMDS;
       }//END IF FOUND CommandAliases entity
-      /*
-      if (facilityLine.find("<Positions>") != string::npos) {
+      //no posBlock... the Positions block is retained like any other line
+      if (!posBlock.empty() && facilityLine.find("<Positions>") != string_view::npos) {
         //check for bad format
         if (type != InfoType::NONE) {
           status_ += FACILITY_FILE_FORMAT;
@@ -798,40 +4694,46 @@ void updateFacilityFiles(
         orig = false;
         type = InfoType::POS;
       }//END IF FOUND Positions entity
-      */
 
       if (orig) {
-        if (firstDone) newFacilityFile << endl << facilityLine;
+        //a line after the first is preceded by its own \n in
+        //  origFacilityBuf, so consecutive retained lines become one span
+        if (firstDone) newFacilityFile.push(string_view(facilityLine.data() - 1, facilityLine.size() + 1));
         else {
-          newFacilityFile << facilityLine;
+          newFacilityFile.push(facilityLine);
           firstDone = true;
         }//end if firstDone ... else
       }//end if orig
 
-      if ((type == InfoType::CMDS)&&(facilityLine.find("<CommandAliasesLastImported>") != string::npos)) {
+      if ((type == InfoType::CMDS)&&(facilityLine.find("<CommandAliasesLastImported>") != string_view::npos)) {
         orig = true;
         type = InfoType::NONE;
-        newFacilityFile << endl << cmdBlock;
+        newFacilityFile.push(newLine);
+        newFacilityFile.push(cmdBlock);
       }
-      /*
-      if ((type == InfoType::POS) && (facilityLine.find("</Positions>") != string::npos)) {
+      if ((type == InfoType::POS) && (facilityLine.find("</Positions>") != string_view::npos)) {
         orig = true;
         type = InfoType::NONE;
-        newFacilityFile << endl << posBlock;
+        newFacilityFile.push(newLine);
+        newFacilityFile.push(posBlock);
       }
-      */
     }//END LOOP THRU LINES OF THIS FACILITY FILE
 
     //newFacilityFile.close();
     //gzipFile(newFacilityFilePath);
 
+    //before anything is deleted... the original must survive a bad splice
+    validateFacilityXML(newFacilityFile, facilityFilePath);
+
     path newFacilityFilePath(argLst[facilityIdx]);
     //auto-clobber if input and output names are the same
     if (newFacilityFilePath == facilityFilePath)
       delFilePath(newFacilityFilePath);
     else
       verifyNDelFilePath(newFacilityFilePath);
-    gzipStrm(newFacilityFile, newFacilityFilePath);
+    SpanStrmBuf newFacilityBuf(newFacilityFile);
+    istream newFacilityStrm(&newFacilityBuf);
+    gzipStrm(newFacilityStrm, newFacilityFilePath);
   }//END LOOP THRU FACILITY FILES
 }//end updateFacilityFiles
 
@@ -0,0 +1,1717 @@
+﻿/*
+Description: Tests and benchmarks for convertVRCalias2XML.cpp
+  (compiled right into this driver, without its main)
+Usage: Alias2FacilityTests
+         runs every test, rtns the number that failed
+       Alias2FacilityTests --bench
+         times the conversion stages against the code they replaced
+         (kept in here as the baselines) on generated input, so the
+         numbers can be reproduced on any machine
+*/
+
+//////////////////////////////////////////////////////////////////////////////
+//INCLUDE FILES & NAMESPACES
+//////////////////////////////////////////////////////////////////////////////
+#define ALIAS2FACILITY_NO_MAIN
+#include "../Alias2Facility/convertVRCalias2XML.cpp"
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////////
+//STRUCTS & CLASSES
+//////////////////////////////////////////////////////////////////////////////
+typedef struct TestCase {
+public:
+  char const* name;
+  void (*run)();
+} TestCase;
+
+//deterministic (xorshift) numbers for the generated input
+//  the same seed gives the same input with every compiler and library
+typedef struct TestRng {
+public:
+  explicit TestRng(uint64_t seed) : state(seed) {}
+  uint32_t next(uint32_t bound) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<uint32_t>(state % bound);
+  }
+
+  uint64_t state;
+} TestRng;
+
+//the Position the operator+ chain was fed, as it was before the
+//  element writer (see oldInitPosition())
+typedef struct OldPosition {
+public:
+  string sectorName, radioName, prefix, suffix, sectorID, positionType;
+  char posSym = '\0';
+  float freq = -1.0;
+} OldPosition;
+
+//////////////////////////////////////////////////////////////////////////////
+//CONSTANTS
+//////////////////////////////////////////////////////////////////////////////
+//aliases in the generated alias file, about the size of a merged ARTCC file
+size_t static const BENCH_ALIAS_CNT = 40000;
+//best of this many runs is reported
+int static const BENCH_RUN_CNT = 20;
+
+//////////////////////////////////////////////////////////////////////////////
+//GLOBAL VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+int failCnt_ = 0;
+char const* testName_ = "";
+//heap allocations made so far (see operator new below)
+atomic<size_t> allocCnt_{ 0 };
+
+//////////////////////////////////////////////////////////////////////////////
+//FUNCTION DECLARATIONS
+//////////////////////////////////////////////////////////////////////////////
+//counts (and reports) a failure of the running test if isOK is false
+void chk(bool isOK, string const& what);
+//best time of runCnt calls of fn, in ms
+template <typename Fn>
+double timeBest(int runCnt, Fn&& fn);
+void prntBench(string_view what, double ms, size_t byteCnt);
+//the heap allocations fn makes
+template <typename Fn>
+size_t countAllocs(Fn&& fn);
+//a VRC alias file of aliasCnt aliases with comment and blank lines in
+//  between and some XML special characters in the replacements
+string genAliasBuf(size_t aliasCnt);
+//an AliasTable of the {command, replacement} pairs, in its owners
+void makeAliasTable(vector<pair<string, string>> const& aliasLst, AliasTable& aliasTable);
+//a VRC POF file of posCnt positions on random 25 kHz channels, with
+//  comment lines in between
+//the sector IDs are taken from sectorIDLst
+string genPofBuf(size_t posCnt, vector<string> const& sectorIDLst);
+//an InFileBuf holding a copy of buf (as if it was read)
+InFileBuf makeInFileBuf(string_view buf);
+//an alias source named srcName, held in memory (as if it was read)
+AliasSrc makeAliasSrc(string_view aliasBuf, string const& srcName);
+//a FILE* opened for reading on a temp file holding text (the way a pipe
+//  is read, in binary)... fclose() it, then remove strmPath
+FILE* openTextStrm(string_view text, path& strmPath);
+
+//the code the optimized versions replaced, as the benchmark baselines
+void oldEscapeXML(string& str);
+string oldCnvrtVRCaliasLine2XML(string const& aliasLine);
+stringstream oldCnvrtVRCalias2XML(istream& vrcAliasFile);
+OldPosition oldInitPosition(string const& positionLine);
+//the operator+ chains that wrote the elements, from escaped fields
+string oldCommandAliasElem(string const& cmdName, string const& rplcmnt);
+string oldPositionInfoElem(OldPosition const& pos);
+//a POF frequency thru stream >> float and (MHz - 100) * 1000, then to_string()
+string oldFmtFreq(string const& freqField);
+//the positionType of sectorID by the two set lookups Config::classify() replaced
+SectorClass oldClassify(string_view sectorID);
+
+void testScanAliasLines();
+void testRunTasks();
+void testAliasGraph();
+void testLintAliasBody();
+void testEscapeXML();
+void testXMLElemWriter();
+void testFreq();
+void testSectorClass();
+void testEncoding();
+void testLineStrmReader();
+void testAliasCache();
+void testAliasEngine();
+void testCmdPrefixIdx();
+void testSpanLst();
+void testXMLValidator();
+
+void benchScanAliasLines();
+void benchAliasAllocs();
+void benchEscapeXML();
+void benchXMLElemWriter();
+void benchCompactOutput();
+void benchSectorClass();
+void benchEncoding();
+void benchLint();
+void benchAliasEngine();
+void benchCmdPrefixIdx();
+void benchFreq();
+
+//every heap allocation of the program goes thru here, so the benchmarks
+//  can count them
+void* operator new(size_t size) {
+  ++allocCnt_;
+  if (void* mem = malloc(size ? size : 1)) return mem;
+  throw bad_alloc();
+}
+void operator delete(void* mem) noexcept { free(mem); }
+void operator delete(void* mem, size_t) noexcept { free(mem); }
+
+//////////////////////////////////////////////////////////////////////////////
+//MAIN FUNCTION
+//////////////////////////////////////////////////////////////////////////////
+TestCase static const TEST_LST[] = {
+  { "scanAliasLines", testScanAliasLines },
+  { "runTasks", testRunTasks },
+  { "AliasGraph", testAliasGraph },
+  { "lintAliasBody", testLintAliasBody },
+  { "escapeXML", testEscapeXML },
+  { "XML element writer", testXMLElemWriter },
+  { "parseFreq/fmtFreq", testFreq },
+  { "Config::classify", testSectorClass },
+  { "encoding stage", testEncoding },
+  { "LineStrmReader", testLineStrmReader },
+  { "alias cache", testAliasCache },
+  { "AliasEngine", testAliasEngine },
+  { "CmdPrefixIdx", testCmdPrefixIdx },
+  { "SpanLst/SpanStrmBuf", testSpanLst },
+  { "XMLValidator", testXMLValidator },
+};
+TestCase static const BENCH_LST[] = {
+  { "scanAliasLines", benchScanAliasLines },
+  { "alias conversion allocations", benchAliasAllocs },
+  { "escapeXML", benchEscapeXML },
+  { "XML element writer", benchXMLElemWriter },
+  { "--compact output", benchCompactOutput },
+  { "Config::classify", benchSectorClass },
+  { "encoding stage", benchEncoding },
+  { "lint", benchLint },
+  { "AliasEngine", benchAliasEngine },
+  { "CmdPrefixIdx", benchCmdPrefixIdx },
+  { "parseFreq/fmtFreq", benchFreq },
+};
+
+int main(int numArgs, char* argLst[]) {
+  if (numArgs > 1 && string_view(argLst[1]) == "--bench") {
+    //LOOP THRU BENCHMARKS
+    for (TestCase const& bench : BENCH_LST) {
+      cout << bench.name << ":" << endl;
+      bench.run();
+    }//END LOOP THRU BENCHMARKS
+    return 0;//!!! EXIT FUNCTION HERE !!!//
+  }
+
+  //LOOP THRU TESTS
+  for (TestCase const& test : TEST_LST) {
+    testName_ = test.name;
+    test.run();
+  }//END LOOP THRU TESTS
+  cout << size(TEST_LST) << " tests, " << failCnt_ << " failures" << endl;
+  return failCnt_;
+}//end main
+//////////////////////////////////////////////////////////////////////////////
+//END MAIN FUNCTION
+//////////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------------
+void chk(bool isOK, string const& what) {
+  if (isOK) return;//!!! EXIT FUNCTION HERE !!!//
+  ++failCnt_;
+  cerr << "FAILED " << testName_ << ": " << what << endl;
+}//end chk
+
+//----------------------------------------------------------------------------
+template <typename Fn>
+double timeBest(int runCnt, Fn&& fn) {
+  double bestMs = numeric_limits<double>::max();
+  for (int runIdx = 0; runIdx < runCnt; ++runIdx) {
+    auto startTime = chrono::steady_clock::now();
+    fn();
+    chrono::duration<double, milli> runTime = chrono::steady_clock::now() - startTime;
+    bestMs = min(bestMs, runTime.count());
+  }
+  return bestMs;
+}//end timeBest
+
+//----------------------------------------------------------------------------
+void prntBench(string_view what, double ms, size_t byteCnt) {
+  cout << "  " << what << ": " << ms << " ms";
+  if (byteCnt != 0) cout << " (" << (byteCnt / 1e6) / (ms / 1e3) << " MB/s)";
+  cout << endl;
+}//end prntBench
+
+//----------------------------------------------------------------------------
+template <typename Fn>
+size_t countAllocs(Fn&& fn) {
+  size_t startCnt = allocCnt_;
+  fn();
+  return allocCnt_ - startCnt;
+}//end countAllocs
+
+//----------------------------------------------------------------------------
+string genAliasBuf(size_t aliasCnt) {
+  char const* const wordLst[] = {
+    "$aircraft", "cleared", "to", "the", "$arr", "airport", "via", "$route",
+    "climb", "and", "maintain", "$calt", "&", "\"direct\"", "<fix>", "it's",
+    "$uc($1)", "$radioname($1)", "squawk", "$squawk", ".msg", "contact"
+  };
+  TestRng rng(2021);
+  string aliasBuf;
+  //LOOP THRU ALIASES
+  for (size_t aliasIdx = 0; aliasIdx < aliasCnt; ++aliasIdx) {
+    if (rng.next(8) == 0) aliasBuf += "; group " + to_string(aliasIdx) + "\r\n";
+    if (rng.next(16) == 0) aliasBuf += "\r\n";
+    aliasBuf += ".cmd" + to_string(aliasIdx);
+    uint32_t wordCnt = 2 + rng.next(12);
+    for (uint32_t wordIdx = 0; wordIdx < wordCnt; ++wordIdx) {
+      aliasBuf += ' ';
+      aliasBuf += wordLst[rng.next(static_cast<uint32_t>(size(wordLst)))];
+    }
+    aliasBuf += "\r\n";
+  }//END LOOP THRU ALIASES
+  return aliasBuf;
+}//end genAliasBuf
+
+//----------------------------------------------------------------------------
+InFileBuf makeInFileBuf(string_view buf) {
+  InFileBuf inBuf;
+  inBuf.bulkBuf_ = make_unique<char[]>(buf.size() + 1);
+  memcpy(inBuf.bulkBuf_.get(), buf.data(), buf.size());
+  inBuf.data_ = inBuf.bulkBuf_.get();
+  inBuf.size_ = buf.size();
+  return inBuf;
+}//end makeInFileBuf
+
+//----------------------------------------------------------------------------
+AliasSrc makeAliasSrc(string_view aliasBuf, string const& srcName) {
+  AliasSrc src;
+  src.srcPath = srcName;
+  src.buf = makeInFileBuf(aliasBuf);
+  src.rawSize = aliasBuf.size();
+  src.rawHash = hashBytes(aliasBuf);
+  return src;
+}//end makeAliasSrc
+
+//----------------------------------------------------------------------------
+FILE* openTextStrm(string_view text, path& strmPath) {
+  strmPath = filesystem::temp_directory_path() / "alias2FacilityTests.strm";
+  ofstream(strmPath, ios::binary).write(text.data(), text.size());
+  return fopen(strmPath.string().c_str(), "rb");
+}//end openTextStrm
+
+//----------------------------------------------------------------------------
+string genPofBuf(size_t posCnt, vector<string> const& sectorIDLst) {
+  char const* const prefixLst[] = { "BOS", "BDL", "PVD", "ALB", "MHT", "PWM" };
+  char const* const suffixLst[] = { "CTR", "APP", "DEP", "TWR" };
+  TestRng rng(2021);
+  string pofBuf;
+  //LOOP THRU POSITIONS
+  for (size_t posIdx = 0; posIdx < posCnt; ++posIdx) {
+    if (rng.next(16) == 0) pofBuf += "; area " + to_string(posIdx) + "\r\n";
+    char const* prefix = prefixLst[rng.next(static_cast<uint32_t>(size(prefixLst)))];
+    char const* suffix = suffixLst[rng.next(static_cast<uint32_t>(size(suffixLst)))];
+    string const& sectorID = sectorIDLst[rng.next(static_cast<uint32_t>(sectorIDLst.size()))];
+    uint32_t khz = 118000 + 25 * rng.next(760);
+    string freqStr = to_string(khz / 1000) + '.' + to_string(khz % 1000 + 1000).substr(1);
+    pofBuf += string(prefix) + " Sector " + to_string(posIdx) + (rng.next(8) == 0 ? " & Co" : "")
+      + ':' + prefix + '_' + sectorID + '_' + suffix + ':' + freqStr + ':' + sectorID + ':'
+      + static_cast<char>('A' + rng.next(26)) + ':' + prefix + ':' + suffix + ":\r\n";
+  }//END LOOP THRU POSITIONS
+  return pofBuf;
+}//end genPofBuf
+
+//////////////////////////////////////////////////////////////////////////////
+//BASELINES
+//////////////////////////////////////////////////////////////////////////////
+//----------------------------------------------------------------------------
+//one find/replace pass per character... quadratic on escape-heavy strings
+void oldEscapeXML(string& str) {
+  char searchTermLst[4] = { '&', '"', '\'', '<' };
+  string replacementLst[4] = { "&amp;", "&quot;", "&apos;", "&lt;" };
+  char term = '\0';
+  string rplcmnt;
+  size_t escapePos = -1;
+  //LOOP THRU INVALID terms
+  for (int termIdx = 0; termIdx < 4; ++termIdx) {
+    term = searchTermLst[termIdx];
+    rplcmnt = replacementLst[termIdx];
+    escapePos = str.find(term);
+    //LOOP WHILE AN INSTNACE OF term IS STILL IN str
+    while (escapePos != string::npos) {
+      str.replace(escapePos, 1, rplcmnt);
+      escapePos += (rplcmnt.length() - 1);
+      escapePos = str.find(term, escapePos);
+    }//END LOOP THRU str FOR term
+  }//END LOOP THRU INVALID CHARS
+}//end oldEscapeXML
+
+//----------------------------------------------------------------------------
+//two substr copies, two escapes and an operator+ chain per line
+string oldCnvrtVRCaliasLine2XML(string const& aliasLine) {
+  size_t cmdNameLen = aliasLine.find(' ');
+  size_t rplcmntIdx = cmdNameLen + 1;
+
+  string cmdName = aliasLine.substr(0, cmdNameLen);
+  string rplcmnt = aliasLine.substr(rplcmntIdx);
+
+  oldEscapeXML(cmdName);
+  oldEscapeXML(rplcmnt);
+
+  return "      <CommandAlias Command=\"" + cmdName + "\" ReplaceWith=\"" + rplcmnt + "\" />";
+}//end oldCnvrtVRCaliasLine2XML
+
+//----------------------------------------------------------------------------
+//a string per line from getline, the block in a stringstream
+stringstream oldCnvrtVRCalias2XML(istream& vrcAliasFile) {
+  string aliasLine;
+  stringstream cmdAliasesXML;
+  cmdAliasesXML << "    <CommandAliases>";
+  //LOOP THRU LINES OF VRC ALIAS FILE
+  while (getline(vrcAliasFile, aliasLine)) {
+    if (aliasLine[0] != '.') continue; //!!!GO TO NEXT LINE!!!//
+    cmdAliasesXML << endl << oldCnvrtVRCaliasLine2XML(aliasLine);
+  }//END LOOP THRU VRC ALIAS FILE
+  cmdAliasesXML << endl << "    </CommandAliases>";
+  cmdAliasesXML << endl << "    <CommandAliasesLastImported>" + getUpdateTimeStr() + "</CommandAliasesLastImported>";
+
+  return cmdAliasesXML;
+}//end oldCnvrtVRCalias2XML
+
+//----------------------------------------------------------------------------
+void makeAliasTable(vector<pair<string, string>> const& aliasLst, AliasTable& aliasTable) {
+  //LOOP THRU ALIASES
+  for (pair<string, string> const& alias : aliasLst) {
+    aliasTable.cmdIdxOwner.push_back(static_cast<uint32_t>(aliasTable.arenaOwner.size()));
+    aliasTable.cmdLenOwner.push_back(static_cast<uint32_t>(alias.first.size()));
+    aliasTable.arenaOwner += alias.first;
+    aliasTable.rplcmntIdxOwner.push_back(static_cast<uint32_t>(aliasTable.arenaOwner.size()));
+    aliasTable.rplcmntLenOwner.push_back(static_cast<uint32_t>(alias.second.size()));
+    aliasTable.arenaOwner += alias.second;
+  }//END LOOP THRU ALIASES
+  aliasTable.useOwners();
+}//end makeAliasTable
+
+//----------------------------------------------------------------------------
+//a stringstream and a getline per field, (MHz - 100) * 1000 as a float
+OldPosition oldInitPosition(string const& positionLine) {
+  OldPosition pos;
+  stringstream posLineStrm(positionLine);
+  getline(posLineStrm, pos.sectorName, ':');
+  getline(posLineStrm, pos.radioName, ':');
+  posLineStrm >> pos.freq;
+  posLineStrm.ignore(1, ':');
+  getline(posLineStrm, pos.sectorID, ':');
+  posLineStrm >> pos.posSym;
+  posLineStrm.ignore(1, ':');
+  getline(posLineStrm, pos.prefix, ':');
+  getline(posLineStrm, pos.suffix, ':');
+
+  pos.freq = (pos.freq - 100) * 1000;
+  oldEscapeXML(pos.sectorName);
+  oldEscapeXML(pos.radioName);
+  oldEscapeXML(pos.prefix);
+  oldEscapeXML(pos.suffix);
+  oldEscapeXML(pos.sectorID);
+
+  if (cfg_.adjacentLst.count(pos.sectorID))
+    pos.positionType = "Adjacent";
+  else if (cfg_.inFacilityLst.count(pos.sectorID))
+    pos.positionType = "InFacility";
+  else
+    pos.positionType = "Other";
+
+  return pos;
+}//end oldInitPosition
+
+//----------------------------------------------------------------------------
+string oldCommandAliasElem(string const& cmdName, string const& rplcmnt) {
+  return "      <CommandAlias Command=\"" + cmdName + "\" ReplaceWith=\"" + rplcmnt + "\" />";
+}//end oldCommandAliasElem
+
+//----------------------------------------------------------------------------
+string oldPositionInfoElem(OldPosition const& pos) {
+  return "      <PositionInfo PositionType=\""s + pos.positionType + "\" SectorName=\"" + pos.sectorName
+    + "\" RadioName=\"" + pos.radioName + "\" Prefix=\"" + pos.prefix + "\" Suffix=\"" + pos.suffix
+    + "\" Frequency=\"" + to_string(pos.freq) + "\" SectorID=\"" + pos.sectorID
+    + "\" PositionSymbol=\"" + pos.posSym + "\" />";
+}//end oldPositionInfoElem
+
+//----------------------------------------------------------------------------
+string oldFmtFreq(string const& freqField) {
+  float freq = 0;
+  istringstream freqStrm(freqField);
+  freqStrm >> freq;
+  freq = (freq - 100) * 1000;
+  return to_string(freq);
+}//end oldFmtFreq
+
+//----------------------------------------------------------------------------
+SectorClass oldClassify(string_view sectorID) {
+  string sectorIDKey(sectorID);
+  if (cfg_.adjacentLst.count(sectorIDKey)) return SectorClass::ADJACENT;//!!! EXIT FUNCTION HERE !!!//
+  if (cfg_.inFacilityLst.count(sectorIDKey)) return SectorClass::IN_FACILITY;//!!! EXIT FUNCTION HERE !!!//
+  return SectorClass::OTHER;
+}//end oldClassify
+
+//////////////////////////////////////////////////////////////////////////////
+//TESTS
+//////////////////////////////////////////////////////////////////////////////
+//----------------------------------------------------------------------------
+void testScanAliasLines() {
+  string aliasBuf = genAliasBuf(5000);
+  //lines that end exactly at a vector boundary, no final \n, no space
+  aliasBuf += string(31, 'x') + "\n.a\n.b c\n" + string(64, ' ') + "\n.end";
+
+  uint32_t lineCnt = 0, scanLineCnt = 0;
+  vector<AliasLineIdx> lineLst = scanAliasLinesScalar(aliasBuf, lineCnt);
+  chk(lineLst.size() > 5000, "every alias line found");
+  //LOOP THRU VECTOR SCANNERS
+  for (auto scanFn : { scanAliasLines
+#ifdef X86_SIMD
+    , scanAliasLinesSSE2, cpuHasAVX2() ? scanAliasLinesAVX2 : scanAliasLinesSSE2
+#endif
+  }) {
+    vector<AliasLineIdx> scanLineLst = scanFn(aliasBuf, scanLineCnt);
+    bool isSame = scanLineLst.size() == lineLst.size() && scanLineCnt == lineCnt;
+    for (size_t lineIdx = 0; isSame && lineIdx < lineLst.size(); ++lineIdx) {
+      isSame = scanLineLst[lineIdx].lineIdx == lineLst[lineIdx].lineIdx
+        && scanLineLst[lineIdx].lineLen == lineLst[lineIdx].lineLen
+        && scanLineLst[lineIdx].splitLen == lineLst[lineIdx].splitLen
+        && scanLineLst[lineIdx].lineNum == lineLst[lineIdx].lineNum;
+    }
+    chk(isSame, "vector scanner matches the scalar one");
+  }//END LOOP THRU VECTOR SCANNERS
+
+  AliasLineIdx const& lastLine = lineLst.back();
+  chk(aliasBuf.substr(lastLine.lineIdx, lastLine.lineLen) == ".end", "last line without \\n");
+  chk(lastLine.splitLen == NO_SPLIT, "line without a space");
+}//end testScanAliasLines
+
+//----------------------------------------------------------------------------
+//the pool is reused from batch to batch, so every batch has to see only
+//  its own tasks, including batches smaller than the pool
+void testRunTasks() {
+  //LOOP THRU BATCHES
+  for (size_t batchIdx = 0; batchIdx < 200; ++batchIdx) {
+    size_t taskCnt = batchIdx % 37;
+    vector<atomic<uint32_t>> callCntLst(taskCnt);
+    runTasks(taskCnt, [&](size_t taskIdx) { ++callCntLst[taskIdx]; });
+    bool isOnce = true;
+    for (atomic<uint32_t> const& callCnt : callCntLst) isOnce = isOnce && callCnt == 1;
+    chk(isOnce, "every task of batch " + to_string(batchIdx) + " runs once");
+  }//END LOOP THRU BATCHES
+  chk(workerPool_.thrdLst.size() <= max(2u, thread::hardware_concurrency()) - 1,
+    "the workers are started once");
+}//end testRunTasks
+
+//----------------------------------------------------------------------------
+//a replacement that starts with a command that is not an alias (.msg) is
+//  not a ref... and several of them must not make one either
+void testAliasGraph() {
+  AliasTable aliasTable;
+  makeAliasTable({
+    { ".hi", ".msg $aircraft hello" },
+    { ".bye", ".MSG $aircraft bye" },
+    { ".ctm", "ctm $1" },
+    { ".a", ".b $1" },
+    { ".b", ".A" },
+    { ".c", ".ctm x" },
+  }, aliasTable);
+  AliasGraph aliasGraph(aliasTable);
+  chk(aliasGraph.firstEdgeLst.size() == aliasTable.aliasCnt + 1, "one edge list per alias");
+  chk(aliasGraph.edgeLst == vector<uint32_t>({ 4, 3, 2 }), "only the refs to aliases are edges");
+  for (uint32_t refIdx : aliasGraph.edgeLst)
+    chk(refIdx < aliasTable.aliasCnt, "edge to alias " + to_string(refIdx));
+
+  vector<uint32_t> sccIdLst;
+  uint32_t sccCnt = findAliasSCCs(aliasGraph, sccIdLst);
+  chk(sccCnt == 5, "5 components, got " + to_string(sccCnt));
+  chk(sccIdLst[3] == sccIdLst[4], ".a and .b are one cycle");
+  chk(sccIdLst[0] != sccIdLst[1], ".hi and .bye are not joined thru .msg");
+}//end testAliasGraph
+
+//----------------------------------------------------------------------------
+//one case per problem the lint knows, and bodies that must pass clean
+void testLintAliasBody() {
+  typedef struct LintCase {
+  public:
+    char const* body;
+    uint32_t problemCnt;
+    char const* problem; //in the message, if problemCnt is not 0
+  } LintCase;
+  LintCase static const caseLst[] = {
+    { "cleared to $arr via $route", 0, "" },
+    { "$uc($aircraft) contact $radioname($1)", 0, "" },
+    { "(heavy) $uc(x) (see $lc($1))", 0, "" },
+    { "$nosuchvar", 1, "unknown variable: $nosuchvar" },
+    { "$nosuchfunc(x)", 1, "unknown function: $nosuchfunc(" },
+    { "$radioname", 1, "function used without (: $radioname" },
+    { "$aircraft(x)", 1, "variable used as a function: $aircraft(" },
+    { "$uc($lc(x)", 1, "calls left open: 1" },
+    { "$uc(x))", 1, ") without a (: 1" },
+    { "hi :) bye :)", 1, ") without a (: 2" },
+    { ") $uc(x", 2, ") without a (: 1" },
+  };
+
+  vector<AliasTok> tokLst;
+  //LOOP THRU CASES
+  for (LintCase const& lintCase : caseLst) {
+    string lintMsgs;
+    uint32_t problemCnt = lintAliasBody(".t", lintCase.body, true, "", 1, tokLst, lintMsgs);
+    chk(problemCnt == lintCase.problemCnt,
+      string(lintCase.body) + ": " + to_string(problemCnt) + " problems\n" + lintMsgs);
+    if (lintCase.problemCnt != 0)
+      chk(lintMsgs.find(lintCase.problem) != string::npos, string(lintCase.body) + ": " + lintMsgs);
+  }//END LOOP THRU CASES
+
+  string lintMsgs;
+  chk(lintAliasBody(".t", "", false, "", 1, tokLst, lintMsgs) == 1, "no body");
+
+  //lint problems are warnings, unless --lint-strict
+  int const startStatus = status_;
+  reportAliasLint(1);
+  chk(status_ == startStatus, "the lint changed the status without --lint-strict");
+  opts_.lintStrict = true;
+  reportAliasLint(1);
+  opts_.lintStrict = false;
+  chk(status_ == startStatus + ALIAS_LINT, "the lint did not set ALIAS_LINT with --lint-strict");
+  status_ = startStatus;
+
+  //the stray ) stays TEXT, the call before it is still closed
+  uint32_t strayCloseCnt;
+  chk(tokenizeAliasBody("$uc(x))", tokLst, strayCloseCnt) == 0, "$uc(x)) leaves no call open");
+  chk(strayCloseCnt == 1, "$uc(x)) has one stray )");
+  chk(tokLst.size() == 4 && tokLst[2].kind == AliasTokKind::CALL_END
+      && tokLst[3].kind == AliasTokKind::TEXT && tokLst[3].idx == 6,
+    "$uc(x)) tokens");
+}//end testLintAliasBody
+
+//----------------------------------------------------------------------------
+//random strings, heavy on the characters that are (and are not) escaped
+void testEscapeXML() {
+  char const charLst[] = "&\"'<>a b;";
+  TestRng rng(2021);
+  //LOOP THRU RANDOM STRINGS
+  for (int strIdx = 0; strIdx < 20000; ++strIdx) {
+    string str;
+    uint32_t charCnt = rng.next(40);
+    for (uint32_t charIdx = 0; charIdx < charCnt; ++charIdx)
+      str += charLst[rng.next(static_cast<uint32_t>(size(charLst) - 1))];
+    string oldEsc = str;
+    oldEscapeXML(oldEsc);
+    string esc = str;
+    escapeXML(esc);
+    if (esc != oldEsc) {
+      chk(false, "\"" + str + "\" escaped to \"" + esc + "\", not \"" + oldEsc + "\"");
+      break; //!!!EXIT LOOP!!!//
+    }
+  }//END LOOP THRU RANDOM STRINGS
+}//end testEscapeXML
+
+//----------------------------------------------------------------------------
+//the element writer has to write exactly what the operator+ chains wrote
+//  (the frequencies are whole MHz here, the float path is exact for them)
+void testXMLElemWriter() {
+  string out;
+  appendXMLElem(out, COMMAND_ALIAS_FMT, ".t&amp;", XMLRaw{ "a &lt;b&gt; &amp; c" });
+  chk(out == oldCommandAliasElem(".t&amp;amp;", "a &lt;b&gt; &amp; c"), "CommandAlias: " + out);
+
+  string const posLine = "Boston & Co:BOS_20_CTR:124:20:B:BOS:CTR:";
+  XMLStrPool strPool;
+  out.clear();
+  appendPositionXML(out, initPosition(posLine, strPool), strPool);
+  chk(out == oldPositionInfoElem(oldInitPosition(posLine)), "PositionInfo: " + out);
+}//end testXMLElemWriter
+
+//----------------------------------------------------------------------------
+//every 25 kHz airband channel round trips exactly, and is what the old
+//  float path wrote once its float noise is rounded off
+void testFreq() {
+  array<char, FREQ_STR_LEN> freqBuf;
+  //LOOP THRU CHANNELS
+  //  the 8.33 kHz channel names are on a 5 kHz step, 4 of every 25 kHz
+  //  (.x20, .x45, .x70 and .x95) are not channels
+  for (int32_t khz = 118000; khz <= 136995; khz += 5) {
+    if (khz % 25 == 20) continue; //!!!GO TO NEXT CHANNEL!!!//
+    string const field = to_string(khz / 1000) + '.' + to_string(khz % 1000 + 1000).substr(1);
+    int32_t freq = 0;
+    chk(parseFreq(field, freq) && freq == khz - 100000, field + " parsed to " + to_string(freq));
+    string const freqStr(fmtFreq(freq, freqBuf));
+    chk(freqStr == to_string(khz - 100000) + ".000000", field + " formatted as " + freqStr);
+    string const oldFreqStr = oldFmtFreq(field);
+    chk(lround(stod(oldFreqStr)) == freq, field + " was " + oldFreqStr + " on the float path");
+  }//END LOOP THRU CHANNELS
+
+  pair<char const*, int32_t> const goodLst[] = {
+    { " 124.350", 24350 }, { "+124.35", 24350 }, { "124.3500", 24350 },
+    { "124", 24000 }, { ".5", -99500 }, { "124.350:", 24350 },
+  };
+  for (auto const& [field, expectFreq] : goodLst) {
+    int32_t freq = 0;
+    chk(parseFreq(field, freq) && freq == expectFreq, "\"" + string(field) + "\" parsed to " + to_string(freq));
+  }
+  char const* const badLst[] = { "abc", "", " ", ".", "-", "124.3505", "124.35001" };
+  for (char const* field : badLst) {
+    int32_t freq = 12345;
+    chk(!parseFreq(field, freq) && freq == 12345, "\"" + string(field) + "\" was not rejected");
+  }
+  //a rejected field is written the way the float path wrote it (0 MHz)
+  chk(fmtFreq(NO_FREQ, freqBuf) == oldFmtFreq("abc"), "NO_FREQ is " + string(fmtFreq(NO_FREQ, freqBuf)));
+
+  //...and the POF conversion warns about it and sets POF_FREQ
+  string const pofBuf = "; comment\r\n"
+    "Bradley App:BDL_APP:125.800:U20:Y:BDL:APP:\r\n"
+    "Bad App:BAD_APP:118.0083:U21:Y:BAD:APP:\r\n";
+  int const startStatus = status_;
+  ostringstream warnStrm;
+  streambuf* cerrBuf = cerr.rdbuf(warnStrm.rdbuf());
+  string positionsXML = cnvrtVRCpof2XML(pofBuf);
+  cerr.rdbuf(cerrBuf);
+  chk(warnStrm.str().find("\"Bad App\" at line 3") != string::npos, "bad frequency warning: " + warnStrm.str());
+  chk(warnStrm.str().find("Bradley") == string::npos, "a good frequency was warned about");
+  chk(status_ == startStatus + POF_FREQ, "a bad frequency left the status at " + to_string(status_));
+  chk(positionsXML.find("Frequency=\"-100000.000000\"") != string::npos, "the bad position was not written");
+  status_ = startStatus;
+  warnStrm.str("");
+  cerr.rdbuf(warnStrm.rdbuf());
+  cnvrtVRCpof2XML(pofBuf.substr(0, pofBuf.find("Bad")));
+  cerr.rdbuf(cerrBuf);
+  chk(warnStrm.str().empty() && status_ == startStatus, "good frequencies were warned about");
+}//end testFreq
+
+//----------------------------------------------------------------------------
+//a cfg given with --cfg= is loaded by initCfg() and every sector ID in it
+//  gets its configured type (Adjacent wins if it is in both lists)
+void testSectorClass() {
+  path cfgPath = filesystem::temp_directory_path() / "alias2FacilityTests.v2xcfg";
+  {
+    ofstream cfgFileStrm(cfgPath);
+    cfgFileStrm << "B1N B1S 20 LONGID" << endl << "U20 U06 B1S" << endl;
+  }
+  cfg_ = Config();
+  opts_.cfgPath = cfgPath;
+  initCfg(false);
+  chk(cfg_.isSet, "the cfg was loaded");
+
+  pair<char const*, SectorClass> const sectorLst[] = {
+    { "B1N", SectorClass::IN_FACILITY }, { "20", SectorClass::IN_FACILITY },
+    { "LONGID", SectorClass::IN_FACILITY }, { "U20", SectorClass::ADJACENT },
+    { "U06", SectorClass::ADJACENT }, { "B1S", SectorClass::ADJACENT },
+    { "06", SectorClass::OTHER }, { "b1n", SectorClass::OTHER },
+    { "B1N ", SectorClass::OTHER }, { "", SectorClass::OTHER },
+  };
+  for (auto const& [sectorID, sectorClass] : sectorLst)
+    chk(cfg_.classify(sectorID) == sectorClass, "\"" + string(sectorID) + "\" classified as "
+      + string(SECTOR_CLASS_NAME_LST[static_cast<size_t>(cfg_.classify(sectorID))]));
+
+  XMLStrPool strPool;
+  string out;
+  appendPositionXML(out, initPosition("Bradley App:BDL_APP:125.800:U20:Y:BDL:APP:", strPool), strPool);
+  chk(out.find("PositionType=\"Adjacent\"") != string::npos, "U20 position: " + out);
+
+  //random IDs of 0 to 5 chars, so the unpacked ones are covered too
+  TestRng rng(2021);
+  //LOOP THRU RANDOM IDS
+  for (int idIdx = 0; idIdx < 20000; ++idIdx) {
+    string sectorID;
+    uint32_t idLen = rng.next(6);
+    for (uint32_t chrIdx = 0; chrIdx < idLen; ++chrIdx) sectorID += "B1NSU206LOGID"[rng.next(13)];
+    if (cfg_.classify(sectorID) != oldClassify(sectorID)) {
+      chk(false, "\"" + sectorID + "\" is not classified like the sets do");
+      break; //!!!EXIT LOOP!!!//
+    }
+  }//END LOOP THRU RANDOM IDS
+
+  cfg_ = Config();
+  opts_.cfgPath.clear();
+  filesystem::remove(cfgPath);
+}//end testSectorClass
+
+//----------------------------------------------------------------------------
+//the vector findHighByte()s against the scalar one, isUTF8() on the
+//  forms it has to reject, the whole Windows-1252 high half and
+//  normalizeInBuf() on each kind of input
+void testEncoding() {
+  vector<pair<char const*, size_t (*)(string_view)>> findFnLst = {
+    { "findHighByte", findHighByte },
+#ifdef X86_SIMD
+    { "findHighByteSSE2", findHighByteSSE2 },
+#endif
+  };
+#ifdef X86_SIMD
+  if (cpuHasAVX2()) findFnLst.push_back({ "findHighByteAVX2", findHighByteAVX2 });
+#endif
+  //LOOP THRU LENGTHS AND HIGH BYTE OFFSETS (bufLen is no high byte)
+  for (size_t bufLen = 0; bufLen <= 80; ++bufLen) {
+    for (size_t highIdx = 0; highIdx <= bufLen; ++highIdx) {
+      string buf(bufLen, 'a');
+      if (highIdx < bufLen) buf[highIdx] = '\x80';
+      if (highIdx + 1 < bufLen) buf[highIdx + 1] = '\xFF';
+      chk(findHighByteScalar(buf) == highIdx, "findHighByteScalar " + to_string(bufLen) + "/" + to_string(highIdx));
+      for (auto const& [findName, findFn] : findFnLst)
+        chk(findFn(buf) == highIdx, string(findName) + " " + to_string(bufLen) + "/" + to_string(highIdx));
+    }
+  }//END LOOP THRU LENGTHS AND HIGH BYTE OFFSETS
+
+  chk(isUTF8("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"), "valid UTF-8");
+  char const* const badUTF8Lst[] = {
+    "\xC0\x80", "\xE0\x80\x80", "\xF0\x80\x80\x80", //overlong
+    "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", //surrogate, past U+10FFFF
+    "\x80", "caf\xC3", "\xE2\x82", "\xC3\x28", "caf\xE9", //stray, cut off, not continued
+  };
+  for (char const* badUTF8 : badUTF8Lst)
+    chk(!isUTF8(badUTF8), "\"" + string(badUTF8) + "\" is not UTF-8");
+
+  //0x80 - 0x9F (the 5 unassigned ones become the C1 controls) and A0 - FF
+  uint32_t const codePt80Lst[32] = {
+    0x20AC, 0x81, 0x201A, 0x192, 0x201E, 0x2026, 0x2020, 0x2021, 0x2C6, 0x2030, 0x160,
+    0x2039, 0x152, 0x8D, 0x17D, 0x8F, 0x90, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+    0x2013, 0x2014, 0x2DC, 0x2122, 0x161, 0x203A, 0x153, 0x9D, 0x17E, 0x178
+  };
+  //LOOP THRU HIGH BYTES
+  for (uint32_t highByte = 0x80; highByte <= 0xFF; ++highByte) {
+    uint32_t codePt = (highByte < 0xA0) ? codePt80Lst[highByte - 0x80] : highByte;
+    string expectUTF8;
+    if (codePt < 0x800) expectUTF8 = { char(0xC0 | codePt >> 6), char(0x80 | (codePt & 0x3F)) };
+    else expectUTF8 = { char(0xE0 | codePt >> 12), char(0x80 | (codePt >> 6 & 0x3F)), char(0x80 | (codePt & 0x3F)) };
+    string const cp1252 = "x" + string(1, static_cast<char>(highByte)) + "y";
+    chk(cp1252ToUTF8(cp1252, 1) == "x" + expectUTF8 + "y", "Windows-1252 byte " + to_string(highByte));
+  }//END LOOP THRU HIGH BYTES
+
+  typedef struct EncCase {
+  public:
+    char const* name;
+    string raw;
+    TextEnc enc;
+    string normalized;
+  } EncCase;
+  EncCase const caseLst[] = {
+    { "ASCII", ".a b\r\n", TextEnc::ASCII, ".a b\r\n" },
+    { "UTF-8 BOM", "\xEF\xBB\xBF.a b\n", TextEnc::ASCII, ".a b\n" },
+    { "UTF-8", ".a caf\xC3\xA9\n", TextEnc::UTF8, ".a caf\xC3\xA9\n" },
+    { "UTF-8 BOM + UTF-8", "\xEF\xBB\xBF.a \xE2\x82\xAC", TextEnc::UTF8, ".a \xE2\x82\xAC" },
+    { "Windows-1252", ".a \x93hi\x94 caf\xE9 \x80", TextEnc::CP1252, ".a \xE2\x80\x9Chi\xE2\x80\x9D caf\xC3\xA9 \xE2\x82\xAC" },
+    { "UTF-16LE", "\xFF\xFE.\0a\0", TextEnc::UTF16, "\xFF\xFE.\0a\0" },
+    { "UTF-16BE", "\xFE\xFF\0.\0a", TextEnc::UTF16, "\xFE\xFF\0.\0a" },
+    { "empty", "", TextEnc::ASCII, "" },
+  };
+  //LOOP THRU CASES
+  for (EncCase const& encCase : caseLst) {
+    InFileBuf inBuf = makeInFileBuf(encCase.raw);
+    char const* rawData = inBuf.data_;
+    TextEnc enc = normalizeInBuf(inBuf);
+    chk(enc == encCase.enc, string(encCase.name) + ": encoding " + to_string(static_cast<int>(enc)));
+    chk(inBuf.view() == encCase.normalized, string(encCase.name) + ": \"" + string(inBuf.view()) + "\"");
+    //clean input is never copied, at most the BOM is skipped
+    if (enc != TextEnc::CP1252)
+      chk(inBuf.data_ == rawData + (encCase.raw.size() - encCase.normalized.size()), string(encCase.name) + " was copied");
+  }//END LOOP THRU CASES
+}//end testEncoding
+
+//----------------------------------------------------------------------------
+//random lines (LF and CRLF, up to and past the buffer, with and without
+//  a last \n) thru a small buffer, so lines wrap across every refill,
+//  then a whole alias stream thru STRM_BUF_LEN against the file path
+void testLineStrmReader() {
+  size_t const bufLen = 16;
+  path strmPath;
+  TestRng rng(7);
+  //LOOP THRU RANDOM STREAMS
+  for (int strmIdx = 0; strmIdx < 500; ++strmIdx) {
+    vector<string> lineLst;
+    string text;
+    uint32_t lineCnt = rng.next(12);
+    for (uint32_t lineIdx = 0; lineIdx < lineCnt; ++lineIdx) {
+      lineLst.push_back(string(rng.next(bufLen + 1), static_cast<char>('a' + lineIdx)));
+      text += lineLst.back();
+      //an empty last line is only there if it has its \n
+      bool isLast = (lineIdx + 1 == lineCnt) && !lineLst.back().empty();
+      if (!isLast || rng.next(2) == 0) text += (rng.next(2) == 0) ? "\n" : "\r\n";
+    }
+    FILE* strm = openTextStrm(text, strmPath);
+    LineStrmReader reader(strm, bufLen);
+    string_view line;
+    size_t lineIdx = 0;
+    bool isSame = true;
+    while (reader.nextLine(line)) {
+      isSame = isSame && lineIdx < lineLst.size() && line == lineLst[lineIdx];
+      ++lineIdx;
+    }
+    isSame = isSame && lineIdx == lineLst.size() && reader.lineNum == lineLst.size()
+      && !reader.lineTooLong && !ferror(strm);
+    fclose(strm);
+    if (!isSame) {
+      chk(false, "stream " + to_string(strmIdx) + " split at line " + to_string(lineIdx));
+      break; //!!!EXIT LOOP!!!//
+    }
+  }//END LOOP THRU RANDOM STREAMS
+
+  typedef struct LenCase {
+  public:
+    char const* name;
+    string text;
+    size_t lineCnt; //lines read before nextLine() rtns false
+    bool isTooLong;
+  } LenCase;
+  LenCase const lenCaseLst[] = {
+    { "bufLen bytes + LF", "x\n" + string(bufLen, 'y') + "\nz", 3, false },
+    { "bufLen bytes + CRLF", "x\r\n" + string(bufLen, 'y') + "\r\nz", 3, false },
+    { "bufLen bytes, no LF", "x\n" + string(bufLen, 'y'), 2, false },
+    { "bufLen + 1 bytes + LF", "x\n" + string(bufLen + 1, 'y') + "\nz", 1, true },
+    { "bufLen + 1 bytes, no LF", "x\n" + string(bufLen + 1, 'y'), 1, true },
+    { "bufLen + 2 bytes + CRLF", string(bufLen + 2, 'y') + "\r\n", 0, true },
+    { "bufLen bytes + CR, no LF", string(bufLen, 'y') + "\r", 1, false },
+    { "empty", "", 0, false },
+    { "LF only", "\n\r\n", 2, false },
+  };
+  //LOOP THRU LENGTH CASES
+  for (LenCase const& lenCase : lenCaseLst) {
+    FILE* strm = openTextStrm(lenCase.text, strmPath);
+    LineStrmReader reader(strm, bufLen);
+    string_view line;
+    size_t lineCnt = 0;
+    while (reader.nextLine(line)) ++lineCnt;
+    fclose(strm);
+    chk(lineCnt == lenCase.lineCnt && reader.lineNum == lenCase.lineCnt,
+      string(lenCase.name) + ": " + to_string(lineCnt) + " lines");
+    chk(reader.lineTooLong == lenCase.isTooLong, string(lenCase.name) + ": lineTooLong");
+  }//END LOOP THRU LENGTH CASES
+
+  //CRLF aliases and one of exactly STRM_BUF_LEN bytes, with no last \n
+  string aliasBuf = genAliasBuf(2000);
+  string longAlias = ".long ";
+  longAlias += string(STRM_BUF_LEN - longAlias.size(), 'w');
+  aliasBuf += longAlias + "\r\n.last one";
+  opts_.lint = false;
+  opts_.useCache = false;
+  vector<AliasSrc> srcLst;
+  srcLst.push_back(makeAliasSrc(aliasBuf, "strm.txt"));
+  string fileXML = cnvrtVRCalias2XML(srcLst);
+  FILE* strm = openTextStrm(aliasBuf, strmPath);
+  LineStrmReader reader(strm, STRM_BUF_LEN);
+  string strmXML = cnvrtVRCaliasStrm2XML(reader);
+  fclose(strm);
+  opts_.lint = true;
+  opts_.useCache = true;
+  //the two differ only in the LastImported time
+  fileXML.erase(fileXML.rfind('\n'));
+  strmXML.erase(strmXML.rfind('\n'));
+  chk(strmXML == fileXML, "streamed aliases are not converted like the file");
+  chk(strmXML.find(longAlias.substr(6)) != string::npos, "the STRM_BUF_LEN line is missing");
+  filesystem::remove(strmPath);
+}//end testLineStrmReader
+
+//----------------------------------------------------------------------------
+//a cache is only used if nothing changed... a changed source, a cut off
+//  or flipped cache and other options each have to rebuild it, and a
+//  cache that can not be written must not fail the run
+void testAliasCache() {
+  path const cacheDir = filesystem::temp_directory_path() / "alias2FacilityTests.cache";
+  filesystem::create_directories(cacheDir);
+  string const srcName = (cacheDir / "aliases.txt").string();
+  string const aliasBuf = genAliasBuf(30);
+  path cachePath = srcName;
+  cachePath += ALIAS_CACHE_EXT;
+  //the aliases of aliasTable, as copies
+  auto getAliasLst = [](AliasTable const& aliasTable) {
+    vector<pair<string, string>> aliasLst;
+    for (size_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx)
+      aliasLst.emplace_back(aliasTable.cmd(aliasIdx), aliasTable.rplcmnt(aliasIdx));
+    return aliasLst;
+  };
+  //loadAliasTable() of buf, with the cache or (isCached false) without it
+  auto loadAliasLst = [&](string_view buf, bool isCached) {
+    vector<AliasSrc> srcLst;
+    srcLst.push_back(makeAliasSrc(buf, srcName));
+    opts_.useCache = isCached;
+    AliasTable aliasTable;
+    loadAliasTable(srcLst, aliasTable);
+    opts_.useCache = true;
+    return getAliasLst(aliasTable);
+  };
+  auto isCacheHit = [&](string_view buf) {
+    vector<AliasSrc> srcLst;
+    srcLst.push_back(makeAliasSrc(buf, srcName));
+    AliasTable aliasTable;
+    return readAliasCache(cachePath, srcLst, aliasTable);
+  };
+  //the cache of buf was not used, and loading rebuilt a good one
+  auto chkRebuilt = [&](string_view buf, string const& what) {
+    chk(!isCacheHit(buf), what + ": the cache was used");
+    chk(loadAliasLst(buf, true) == loadAliasLst(buf, false), what + ": the rebuilt table differs");
+    chk(isCacheHit(buf), what + ": the cache was not rewritten");
+  };
+
+  filesystem::remove(cachePath);
+  chkRebuilt(aliasBuf, "no cache");
+  //the mapped table has to be the built one
+  {
+    vector<AliasSrc> srcLst;
+    srcLst.push_back(makeAliasSrc(aliasBuf, srcName));
+    AliasTable aliasTable;
+    chk(readAliasCache(cachePath, srcLst, aliasTable)
+      && getAliasLst(aliasTable) == loadAliasLst(aliasBuf, false), "the cached table differs");
+  }
+
+  string const changedBuf = aliasBuf + ".added alias\r\n";
+  chkRebuilt(changedBuf, "changed source");
+  chkRebuilt(aliasBuf, "source changed back");
+
+  uintmax_t const cacheLen = filesystem::file_size(cachePath);
+  filesystem::resize_file(cachePath, cacheLen - 1);
+  chkRebuilt(aliasBuf, "cache cut by 1 byte");
+  filesystem::resize_file(cachePath, sizeof(AliasCacheHdr) - 1);
+  chkRebuilt(aliasBuf, "cache cut in the header");
+
+  //LOOP THRU PAYLOAD BYTES
+  for (uintmax_t byteIdx = sizeof(AliasCacheHdr); byteIdx < cacheLen; ++byteIdx) {
+    fstream cacheStrm(cachePath, ios::in | ios::out | ios::binary);
+    char cacheByte = 0;
+    cacheStrm.seekg(byteIdx);
+    cacheStrm.read(&cacheByte, 1);
+    cacheStrm.seekp(byteIdx);
+    cacheStrm.put(static_cast<char>(cacheByte ^ 0x01));
+    cacheStrm.close();
+    bool isHit = isCacheHit(aliasBuf);
+    if (byteIdx + 1 == cacheLen) {
+      chkRebuilt(aliasBuf, "last payload byte flipped");
+      break; //!!!EXIT LOOP!!!//
+    }
+    cacheStrm.open(cachePath, ios::in | ios::out | ios::binary);
+    cacheStrm.seekp(byteIdx);
+    cacheStrm.put(cacheByte);
+    cacheStrm.close();
+    if (isHit) {
+      chk(false, "payload byte " + to_string(byteIdx) + " flipped and the cache was used");
+      break; //!!!EXIT LOOP!!!//
+    }
+  }//END LOOP THRU PAYLOAD BYTES
+
+  opts_.dropDups = true;
+  chkRebuilt(aliasBuf, "--drop-dups");
+  opts_.dropDups = false;
+  chkRebuilt(aliasBuf, "--drop-dups dropped");
+  opts_.lint = false;
+  chkRebuilt(aliasBuf, "--no-lint");
+  opts_.lint = true;
+  chkRebuilt(aliasBuf, "--no-lint dropped");
+
+  //a cache in a folder that is not there can not be written
+  int const startStatus = status_;
+  vector<AliasSrc> srcLst;
+  srcLst.push_back(makeAliasSrc(aliasBuf, srcName));
+  AliasTable aliasTable;
+  buildAliasTable(srcLst, aliasTable);
+  writeAliasCache(cacheDir / "missing" / "aliases.txt.v2xalias", srcLst, aliasTable);
+  chk(status_ == startStatus, "a cache write failure changed the status to " + to_string(status_));
+
+  filesystem::remove_all(cacheDir);
+}//end testAliasCache
+
+//----------------------------------------------------------------------------
+//parameters, built-in and other variables, $uc()/$lc(), functions from
+//  the context (nested too), aliases that expand to aliases and the cap
+//  on how deep that goes
+void testAliasEngine() {
+  vector<pair<string, string>> aliasLst = {
+    { ".ctm", "cleared to $1 maintain $2$3" },
+    { ".case", "$uc($1) $lc($2) $UC(mIxEd)" },
+    { ".who", "$callsign at $ALT, $squawk" },
+    { ".var", "$foo/$FOO/$nope" },
+    { ".fq", "$freq($1) $metar($1)" },
+    { ".nest", "$uc($freq($1)) $lc($uc(a)B) ($1)" },
+    { ".esc", "&lt;$1&gt; &amp; &quot;$2&quot;" },
+    { ".a", ".b $2 $1" },
+    { ".b", ".CTM $1 $2" },
+    { ".loop", ".loop" },
+    { ".dup", "first" },
+    { ".dup", "last" },
+    { ".open", "$uc(never closed" },
+  };
+  //.c0 -> .c1 -> ... -> .cN -> end, one more alias than can be expanded
+  for (uint32_t chainIdx = 0; chainIdx <= ALIAS_EXPAND_MAX_DEPTH + 1; ++chainIdx)
+    aliasLst.push_back({ ".c" + to_string(chainIdx), ".c" + to_string(chainIdx + 1) });
+  aliasLst.push_back({ ".c" + to_string(ALIAS_EXPAND_MAX_DEPTH + 2), "end" });
+  AliasTable aliasTable;
+  makeAliasTable(aliasLst, aliasTable);
+  AliasEngine aliasEngine(aliasTable);
+
+  ExpandCtx ctx;
+  ctx.builtinValLst.resize(size(ALIAS_BUILTIN_LST));
+  ctx.builtinValLst[findAliasBuiltin("callsign") - ALIAS_BUILTIN_LST] = "N123AB";
+  ctx.builtinValLst[findAliasBuiltin("alt") - ALIAS_BUILTIN_LST] = "5000";
+  ctx.varValLst["foo"] = "bar";
+  ctx.funcValLst["freq(zny_ctr)"] = "125.325";
+  ctx.funcValLst["metar(zny_ctr)"] = "KJFK 121251Z";
+
+  typedef struct ExpandCase {
+  public:
+    char const* cmdLine;
+    bool isAlias;
+    string expansion;
+  } ExpandCase;
+  string const cN = ".c" + to_string(ALIAS_EXPAND_MAX_DEPTH + 1);
+  ExpandCase const caseLst[] = {
+    { ".ctm N123AB 5000", true, "cleared to N123AB maintain 5000" },
+    { "  .CTM   N123AB  5000 ", true, "cleared to N123AB maintain 5000" },
+    { ".ctm N123AB", true, "cleared to N123AB maintain " },
+    { ".case aBc DeF", true, "ABC def MIXED" },
+    { ".who", true, "N123AB at 5000, " },
+    { ".var", true, "bar/bar/" },
+    { ".fq ZNY_CTR", true, "125.325 KJFK 121251Z" },
+    { ".fq zny_ctr", true, "125.325 KJFK 121251Z" },
+    { ".fq ZBW_CTR", true, " " },
+    { ".nest zny_ctr", true, "125.325 ab (zny_ctr)" },
+    { ".esc x y", true, "<x> & \"y\"" },
+    { ".a 5000 N123AB", true, "cleared to N123AB maintain 5000" },
+    { ".loop", true, ".loop" },
+    { ".dup", true, "last" },
+    { ".open x", true, "never closed" },
+    //the first expansion and ALIAS_EXPAND_MAX_DEPTH more
+    { ".c2", true, "end" },
+    { ".c0", true, cN },
+    { ".nope x", false, "" },
+    { "ctm x", false, "" },
+    { "", false, "" },
+  };
+  string expansion;
+  //LOOP THRU CASES
+  for (ExpandCase const& expandCase : caseLst) {
+    bool isAlias = aliasEngine.expand(expandCase.cmdLine, ctx, expansion);
+    chk(isAlias == expandCase.isAlias && expansion == expandCase.expansion,
+      "\"" + string(expandCase.cmdLine) + "\" expanded to \"" + expansion + "\"");
+  }//END LOOP THRU CASES
+
+  //run() appends one alias, without expanding its result again
+  expansion = "> ";
+  vector<string_view> paramLst = { ".a", "x", "y" };
+  aliasEngine.run(7, paramLst, ctx, expansion);
+  chk(expansion == "> .b y x", "run(.a) gave \"" + expansion + "\"");
+}//end testAliasEngine
+
+//----------------------------------------------------------------------------
+//findPrefix() against checking every command, on a few hand picked
+//  commands and on random ones from a small alphabet (so there are many
+//  shared prefixes, case differences and equal commands)
+void testCmdPrefixIdx() {
+  //[first, last) must hold exactly the commands with the prefix, in order
+  auto chkPrefix = [](CmdPrefixIdx const& prefixIdx, AliasTable const& aliasTable, string_view prefix) {
+    pair<size_t, size_t> range = prefixIdx.findPrefix(prefix);
+    size_t matchCnt = 0;
+    for (size_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx)
+      matchCnt += cmdHasPrefix(aliasTable.cmd(aliasIdx), prefix);
+    bool isOK = range.first <= range.second && range.second - range.first == matchCnt;
+    for (size_t sortedIdx = range.first; isOK && sortedIdx < range.second; ++sortedIdx)
+      isOK = cmdHasPrefix(prefixIdx.cmd(sortedIdx), prefix);
+    return isOK;
+  };
+  //sorted without regard to case, equal commands in table order
+  auto isSorted = [](CmdPrefixIdx const& prefixIdx) {
+    for (size_t sortedIdx = 1; sortedIdx < prefixIdx.cmdIdxLst.size(); ++sortedIdx) {
+      int cmp = cmpCmd(prefixIdx.cmd(sortedIdx - 1), prefixIdx.cmd(sortedIdx));
+      if (cmp > 0 || (cmp == 0 && prefixIdx.aliasIdxLst[sortedIdx - 1] > prefixIdx.aliasIdxLst[sortedIdx]))
+        return false;
+    }
+    return true;
+  };
+
+  AliasTable aliasTable;
+  makeAliasTable({
+    { ".ctm", "a" }, { ".CTMX", "b" }, { ".cta", "c" }, { ".d", "d" },
+    { ".ct", "e" }, { ".ctmx", "f" }, { ".Ctm", "g" }, { ".ctmxx", "h" },
+  }, aliasTable);
+  CmdPrefixIdx prefixIdx(aliasTable);
+  chk(isSorted(prefixIdx), "the commands are not sorted");
+  vector<string_view> sortedLst;
+  for (size_t sortedIdx = 0; sortedIdx < prefixIdx.cmdIdxLst.size(); ++sortedIdx)
+    sortedLst.push_back(prefixIdx.cmd(sortedIdx));
+  chk(sortedLst == vector<string_view>({ ".ct", ".cta", ".ctm", ".Ctm", ".CTMX", ".ctmx", ".ctmxx", ".d" }),
+    "sorted order");
+
+  typedef struct PrefixCase {
+  public:
+    char const* prefix;
+    size_t first;
+    size_t last;
+  } PrefixCase;
+  PrefixCase const caseLst[] = {
+    { "", 0, 8 }, { ".", 0, 8 }, { ".c", 0, 7 }, { ".CT", 0, 7 }, { ".ctm", 2, 7 },
+    { ".CTMX", 4, 7 }, { ".ctmxx", 6, 7 }, { ".ctmxxx", 7, 7 }, { ".ctb", 2, 2 },
+    { ".d", 7, 8 }, { ".z", 8, 8 }, { "!", 0, 0 }, { "ctm", 8, 8 },
+  };
+  //LOOP THRU CASES
+  for (PrefixCase const& prefixCase : caseLst) {
+    pair<size_t, size_t> range = prefixIdx.findPrefix(prefixCase.prefix);
+    //an empty range only has to be in the right place
+    bool isOK = (prefixCase.first == prefixCase.last)
+      ? range.first == range.second && range.first == prefixCase.first
+      : range == pair<size_t, size_t>(prefixCase.first, prefixCase.last);
+    chk(isOK, "\"" + string(prefixCase.prefix) + "\": [" + to_string(range.first) + ", " + to_string(range.second) + ")");
+  }//END LOOP THRU CASES
+
+  CmdPrefixIdx emptyIdx{ AliasTable() };
+  chk(emptyIdx.findPrefix(".a") == pair<size_t, size_t>(0, 0), "empty index");
+
+  TestRng rng(12);
+  //LOOP THRU RANDOM TABLES
+  for (int tableIdx = 0; tableIdx < 50; ++tableIdx) {
+    auto genCmd = [&](uint32_t maxLen) {
+      string cmd;
+      uint32_t cmdLen = rng.next(maxLen + 1);
+      for (uint32_t chrIdx = 0; chrIdx < cmdLen; ++chrIdx) cmd += ".aAbB"[rng.next(5)];
+      return cmd;
+    };
+    vector<pair<string, string>> aliasLst;
+    uint32_t aliasCnt = rng.next(40);
+    for (uint32_t aliasIdx = 0; aliasIdx < aliasCnt; ++aliasIdx) aliasLst.push_back({ genCmd(4), "x" });
+    AliasTable randTable;
+    makeAliasTable(aliasLst, randTable);
+    CmdPrefixIdx randIdx(randTable);
+    bool isOK = isSorted(randIdx);
+    for (int prefixIdx = 0; isOK && prefixIdx < 40; ++prefixIdx) isOK = chkPrefix(randIdx, randTable, genCmd(5));
+    if (!isOK) {
+      chk(false, "random table " + to_string(tableIdx));
+      break; //!!!EXIT LOOP!!!//
+    }
+  }//END LOOP THRU RANDOM TABLES
+}//end testCmdPrefixIdx
+
+//----------------------------------------------------------------------------
+//random documents of adjacent (merged), separate and empty spans, read
+//  and seeked thru a SpanStrmBuf against the joined text
+void testSpanLst() {
+  string baseBuf(256, ' ');
+  string otherBuf(256, ' ');
+  for (size_t charIdx = 0; charIdx < baseBuf.size(); ++charIdx) {
+    baseBuf[charIdx] = static_cast<char>('A' + charIdx % 26);
+    otherBuf[charIdx] = static_cast<char>('a' + charIdx % 26);
+  }
+  TestRng rng(19);
+  //LOOP THRU RANDOM DOCUMENTS
+  for (int docIdx = 0; docIdx < 200; ++docIdx) {
+    SpanLst doc;
+    string joined;
+    size_t baseIdx = rng.next(16);
+    size_t mergeCnt = 0;
+    uint32_t pushCnt = rng.next(12);
+    for (uint32_t pushIdx = 0; pushIdx < pushCnt; ++pushIdx) {
+      size_t spanLen = rng.next(24);
+      string_view span;
+      //on from the last base span (merged), a gap in the base, or the other buffer
+      uint32_t spanKind = rng.next(3);
+      if (spanKind == 2) span = string_view(otherBuf).substr(rng.next(200), spanLen);
+      else {
+        if (spanKind == 1) baseIdx += 1 + rng.next(4);
+        baseIdx = min(baseIdx, baseBuf.size());
+        span = string_view(baseBuf).substr(baseIdx, spanLen);
+        baseIdx += span.size();
+      }
+      if (!doc.spanLst.empty() && doc.spanLst.back().data() + doc.spanLst.back().size() == span.data()) ++mergeCnt;
+      doc.push(span);
+      joined += span;
+    }
+    string docText;
+    for (string_view span : doc.spanLst) docText += span;
+    bool isOK = docText == joined && doc.len == joined.size() && doc.spanLst.size() == pushCnt - mergeCnt;
+
+    SpanStrmBuf docBuf(doc);
+    istream docStrm(&docBuf);
+    string readText((istreambuf_iterator<char>(docStrm)), istreambuf_iterator<char>());
+    isOK = isOK && readText == joined;
+
+    //LOOP THRU RANDOM SEEKS
+    for (int seekIdx = 0; isOK && seekIdx < 20; ++seekIdx) {
+      docStrm.clear();
+      streamoff off = static_cast<streamoff>(rng.next(static_cast<uint32_t>(joined.size() + 3))) - 1;
+      ios_base::seekdir dir = ios_base::beg;
+      streamoff curPos = docStrm.tellg();
+      streamoff newPos = off;
+      switch (rng.next(3)) {
+      case 1:
+        dir = ios_base::cur;
+        newPos = off;
+        off -= curPos;
+        break;
+      case 2:
+        dir = ios_base::end;
+        newPos = off;
+        off -= static_cast<streamoff>(joined.size());
+        break;
+      }
+      docStrm.seekg(off, dir);
+      if (newPos < 0 || newPos > static_cast<streamoff>(joined.size())) {
+        //a seek out of the document fails and leaves the position alone
+        isOK = docStrm.fail() && (docStrm.clear(), docStrm.tellg() == curPos);
+        continue; //!!!GO TO NEXT SEEK!!!//
+      }
+      isOK = !docStrm.fail() && docStrm.tellg() == newPos;
+      //a read past the end stops at it
+      size_t readLen = rng.next(30);
+      string readBuf(readLen, '\0');
+      docStrm.read(readBuf.data(), static_cast<streamsize>(readLen));
+      readBuf.resize(static_cast<size_t>(docStrm.gcount()));
+      isOK = isOK && readBuf == joined.substr(static_cast<size_t>(newPos), readLen);
+    }//END LOOP THRU RANDOM SEEKS
+    if (!isOK) {
+      chk(false, "document " + to_string(docIdx) + " (\"" + joined + "\")");
+      break; //!!!EXIT LOOP!!!//
+    }
+  }//END LOOP THRU RANDOM DOCUMENTS
+}//end testSpanLst
+
+//----------------------------------------------------------------------------
+//good and bad documents, whole, split in two at every byte offset and
+//  fed a byte at a time... the verdict (and where the error is) must
+//  not depend on how the document is split
+void testXMLValidator() {
+  typedef struct XMLCase {
+  public:
+    string doc;
+    bool isValid;
+  } XMLCase;
+  XMLCase const caseLst[] = {
+    { "<a/>", true },
+    { "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<!-- c -->\n<!DOCTYPE a>\n"
+      "<a x=\"1 &amp; &#60;\" y='&#x1F600;&#9;'>t&lt;&#x10FFFF;<b/><![CDATA[<x>&]]></a>\n<!-- end -->\n", true },
+    { "  <a></a>  \n", true },
+    { "", false },
+    { " \r\n\t", false },
+    { "plain text", false },
+    { "<!-- only a comment -->", false },
+    { "\xEF\xBB\xBF", false },
+    { "hello <a/>", false },
+    { "<a/>x", false },
+    { "<a/>&amp;", false },
+    { "<a/><b/>", false },
+    { "<a></a><a></a>", false },
+    { "<a/>\n<!-- c -->\n<b></b>", false },
+    { "\xEF\xBB<a/>", false },
+    { "<a/>\xEF\xBB\xBF", false },
+    { "<a>&#0;</a>", false },
+    { "<a>&#x0;</a>", false },
+    { "<a b=\"&#1;\"/>", false },
+    { "<a>&#xD800;</a>", false },
+    { "<a>&#xFFFE;</a>", false },
+    { "<a>&#x110000;</a>", false },
+    { "<a>&#1114112;</a>", false },
+    { "<a>&#;</a>", false },
+    { "<a>&#x;</a>", false },
+    { "<a>&bogus;</a>", false },
+    { "<a>&amp</a>", false },
+    { "<a>", false },
+    { "<a></b>", false },
+    { "</a>", false },
+    { "<a x=1/>", false },
+    { "<a x=\"1\"y=\"2\"/>", false },
+    { "<a><!-- open </a>", false },
+  };
+  //feeds doc cut at each of cutLst, rtns the validator after finish()
+  auto validate = [](string_view doc, vector<size_t> const& cutLst, bool& isValid) {
+    XMLValidator validator;
+    isValid = true;
+    size_t spanStart = 0;
+    for (size_t cutIdx = 0; isValid && cutIdx <= cutLst.size(); ++cutIdx) {
+      size_t spanEnd = (cutIdx < cutLst.size()) ? cutLst[cutIdx] : doc.size();
+      isValid = validator.feed(doc.substr(spanStart, spanEnd - spanStart));
+      spanStart = spanEnd;
+    }
+    isValid = isValid && validator.finish();
+    return validator;
+  };
+
+  //LOOP THRU CASES
+  for (XMLCase const& xmlCase : caseLst) {
+    bool isValid;
+    XMLValidator const wholeValidator = validate(xmlCase.doc, {}, isValid);
+    chk(isValid == xmlCase.isValid, "\"" + xmlCase.doc + "\": " + wholeValidator.errMsg);
+    if (isValid != xmlCase.isValid) continue; //!!!GO TO NEXT CASE!!!//
+
+    vector<vector<size_t>> cutLstLst;
+    for (size_t cutPos = 0; cutPos <= xmlCase.doc.size(); ++cutPos) cutLstLst.push_back({ cutPos });
+    cutLstLst.emplace_back();
+    for (size_t cutPos = 1; cutPos < xmlCase.doc.size(); ++cutPos) cutLstLst.back().push_back(cutPos);
+    //LOOP THRU WAYS TO SPLIT THE DOCUMENT
+    for (vector<size_t> const& cutLst : cutLstLst) {
+      XMLValidator const splitValidator = validate(xmlCase.doc, cutLst, isValid);
+      if (isValid != xmlCase.isValid || splitValidator.errPos != wholeValidator.errPos) {
+        chk(false, "\"" + xmlCase.doc + "\" split " + to_string(cutLst.size() == 1 ? cutLst[0] : 0)
+          + (cutLst.size() > 1 ? " (a byte at a time)" : "") + ": " + splitValidator.errMsg);
+        break; //!!!EXIT LOOP!!!//
+      }
+    }//END LOOP THRU WAYS TO SPLIT THE DOCUMENT
+  }//END LOOP THRU CASES
+}//end testXMLValidator
+
+//////////////////////////////////////////////////////////////////////////////
+//BENCHMARKS
+//////////////////////////////////////////////////////////////////////////////
+//----------------------------------------------------------------------------
+//getline, a check of the first char and a find(' ') per line, the way
+//  cnvrtVRCalias2XML() found the aliases before scanAliasLines()
+void benchScanAliasLines() {
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  size_t aliasCnt = 0;
+
+  double ms = timeBest(BENCH_RUN_CNT, [&]() {
+    istringstream aliasStrm(aliasBuf);
+    string aliasLine;
+    aliasCnt = 0;
+    while (getline(aliasStrm, aliasLine)) {
+      if (aliasLine[0] != '.') continue;
+      aliasCnt += (aliasLine.find(' ') != string::npos);
+    }
+  });
+  prntBench("getline + find(' ') (old)", ms, aliasBuf.size());
+
+  uint32_t lineCnt = 0;
+  vector<pair<char const*, vector<AliasLineIdx> (*)(string_view, uint32_t&)>> scanFnLst = {
+    { "scanAliasLinesScalar", scanAliasLinesScalar },
+#ifdef X86_SIMD
+    { "scanAliasLinesSSE2", scanAliasLinesSSE2 },
+#endif
+  };
+#ifdef X86_SIMD
+  if (cpuHasAVX2()) scanFnLst.push_back({ "scanAliasLinesAVX2", scanAliasLinesAVX2 });
+#endif
+  for (auto const& [scanName, scanFn] : scanFnLst) {
+    ms = timeBest(BENCH_RUN_CNT, [&]() { aliasCnt = scanFn(aliasBuf, lineCnt).size(); });
+    prntBench(scanName, ms, aliasBuf.size());
+  }
+}//end benchScanAliasLines
+
+//----------------------------------------------------------------------------
+//the whole CommandAliases block, from the alias file in memory to the
+//  block string main hands to updateFacilityFiles()
+//the AliasTable is built without the .v2xalias cache
+void benchAliasAllocs() {
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  opts_.useCache = false;
+
+  auto runOld = [&]() {
+    istringstream aliasStrm(aliasBuf);
+    string cmdAliasesXML = oldCnvrtVRCalias2XML(aliasStrm).str();
+  };
+  auto runNew = [&]() {
+    vector<AliasSrc> srcLst;
+    srcLst.push_back(makeAliasSrc(aliasBuf, "bench.txt"));
+    string cmdAliasesXML = cnvrtVRCalias2XML(srcLst);
+  };
+  //once first, so the worker pool is already started
+  runNew();
+
+  size_t allocCnt = countAllocs(runOld);
+  cout << "  per-line strings (old): " << allocCnt << " allocations ("
+    << double(allocCnt) / BENCH_ALIAS_CNT << " per alias)" << endl;
+  prntBench("per-line strings (old)", timeBest(BENCH_RUN_CNT, runOld), aliasBuf.size());
+  allocCnt = countAllocs(runNew);
+  cout << "  AliasTable: " << allocCnt << " allocations ("
+    << double(allocCnt) / BENCH_ALIAS_CNT << " per alias)" << endl;
+  prntBench("AliasTable", timeBest(BENCH_RUN_CNT, runNew), aliasBuf.size());
+}//end benchAliasAllocs
+
+//----------------------------------------------------------------------------
+//the quadratic case of the old find/replace loop (one long run of &) and
+//  the generated alias file, which has a few special characters per line
+void benchEscapeXML() {
+  vector<pair<char const*, string>> inputLst = {
+    { "10k &", string(10000, '&') },
+    { "generated alias file", genAliasBuf(BENCH_ALIAS_CNT / 10) },
+  };
+  //LOOP THRU INPUTS
+  for (auto const& [inputName, input] : inputLst) {
+    string str;
+    double ms = timeBest(BENCH_RUN_CNT, [&]() {
+      str = input;
+      oldEscapeXML(str);
+    });
+    prntBench(string(inputName) + ", find/replace (old)", ms, input.size());
+    ms = timeBest(BENCH_RUN_CNT, [&]() {
+      str = input;
+      escapeXML(str);
+    });
+    prntBench(string(inputName) + ", escapeXML", ms, input.size());
+  }//END LOOP THRU INPUTS
+}//end benchEscapeXML
+
+//----------------------------------------------------------------------------
+//only the writing of the elements, from fields that are already parsed
+//  and escaped (to_string(float) is part of the old PositionInfo chain,
+//  fmtFreq() of the new one)
+void benchXMLElemWriter() {
+  vector<pair<string, string>> aliasLst;
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  uint32_t lineCnt;
+  for (AliasLineIdx const& aliasLineIdx : scanAliasLines(aliasBuf, lineCnt)) {
+    string cmd(getAliasCmd(aliasBuf, aliasLineIdx)), rplcmnt(getAliasRplcmnt(aliasBuf, aliasLineIdx));
+    escapeXML(cmd);
+    escapeXML(rplcmnt);
+    aliasLst.push_back({ move(cmd), move(rplcmnt) });
+  }
+  string out;
+  double ms = timeBest(BENCH_RUN_CNT, [&]() {
+    out.clear();
+    for (auto const& [cmd, rplcmnt] : aliasLst) {
+      out += '\n';
+      out += oldCommandAliasElem(cmd, rplcmnt);
+    }
+  });
+  prntBench("CommandAlias, operator+ (old)", ms, out.size());
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    out.clear();
+    for (auto const& [cmd, rplcmnt] : aliasLst) {
+      out += '\n';
+      appendXMLElem(out, COMMAND_ALIAS_FMT, XMLRaw{ cmd }, XMLRaw{ rplcmnt });
+    }
+  });
+  prntBench("CommandAlias, appendXMLElem", ms, out.size());
+
+  string const pofBuf = genPofBuf(BENCH_ALIAS_CNT / 2, { "20", "06", "B1N", "U20", "N56" });
+  vector<OldPosition> oldPosLst;
+  vector<Position> posLst;
+  XMLStrPool strPool;
+  string_view pofLeft = pofBuf, positionLine;
+  while (popLine(pofLeft, positionLine)) {
+    if (positionLine[0] == ';') continue;
+    oldPosLst.push_back(oldInitPosition(string(positionLine)));
+    posLst.push_back(initPosition(positionLine, strPool));
+  }
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    out.clear();
+    for (OldPosition const& pos : oldPosLst) {
+      out += '\n';
+      out += oldPositionInfoElem(pos);
+    }
+  });
+  prntBench("PositionInfo, operator+ (old)", ms, out.size());
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    out.clear();
+    for (Position const& pos : posLst) {
+      out += '\n';
+      appendPositionXML(out, pos, strPool);
+    }
+  });
+  prntBench("PositionInfo, appendPositionXML", ms, out.size());
+}//end benchXMLElemWriter
+
+//----------------------------------------------------------------------------
+//both generated blocks, indented and --compact: their size, the time to
+//  build them, and the size and time of gzipping them the way the
+//  facility file is (gzipStrm(), thru bit7z)
+void benchCompactOutput() {
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  string const pofBuf = genPofBuf(BENCH_ALIAS_CNT / 2, { "20", "06", "B1N", "U20", "N56" });
+  path gzPath = filesystem::temp_directory_path() / "alias2FacilityTests.xml.gz";
+  opts_.useCache = false;
+
+  //LOOP THRU MODES
+  for (bool compact : { false, true }) {
+    opts_.compact = compact;
+    string const modeName = compact ? "compact" : "indented";
+    string blocks;
+    double buildMs = timeBest(BENCH_RUN_CNT, [&]() {
+      vector<AliasSrc> srcLst;
+      srcLst.push_back(makeAliasSrc(aliasBuf, "bench.txt"));
+      blocks = cnvrtVRCalias2XML(srcLst) + "\n" + cnvrtVRCpof2XML(pofBuf);
+    });
+    double gzipMs = timeBest(BENCH_RUN_CNT, [&]() {
+      filesystem::remove(gzPath); //gzipStrm() asks before it overwrites
+      istringstream blockStrm(blocks);
+      gzipStrm(blockStrm, gzPath);
+    });
+    cout << "  " << modeName << ": " << blocks.size() << " bytes, gzipped "
+      << filesystem::file_size(gzPath) << " bytes" << endl;
+    prntBench(modeName + ", build", buildMs, blocks.size());
+    prntBench(modeName + ", gzip", gzipMs, blocks.size());
+    prntBench(modeName + ", total", buildMs + gzipMs, 0);
+  }//END LOOP THRU MODES
+  opts_.compact = false;
+  filesystem::remove(gzPath);
+}//end benchCompactOutput
+
+//----------------------------------------------------------------------------
+//the sector IDs of a generated 20k-line POF looked up in a 270-ID cfg,
+//  and the whole Positions block with that cfg
+void benchSectorClass() {
+  TestRng rng(2021);
+  vector<string> sectorIDLst;
+  cfg_ = Config();
+  //LOOP THRU CFG IDS
+  for (int idIdx = 0; idIdx < 270; ++idIdx) {
+    string sectorID = { static_cast<char>('A' + rng.next(26)), static_cast<char>('0' + rng.next(10)) };
+    if (rng.next(2) == 0) sectorID += static_cast<char>('A' + rng.next(26));
+    (idIdx % 3 == 0 ? cfg_.adjacentLst : cfg_.inFacilityLst).insert(sectorID);
+    sectorIDLst.push_back(sectorID);
+  }//END LOOP THRU CFG IDS
+  cfg_.buildSectorClassTbl();
+  //a third of the POF is not in the cfg
+  for (int idIdx = 0; idIdx < 135; ++idIdx) sectorIDLst.push_back("Z" + to_string(idIdx));
+
+  string const pofBuf = genPofBuf(BENCH_ALIAS_CNT / 2, sectorIDLst);
+  vector<string_view> posIDLst;
+  XMLStrPool strPool;
+  string_view pofLeft = pofBuf, positionLine;
+  while (popLine(pofLeft, positionLine)) {
+    if (positionLine[0] == ';') continue;
+    posIDLst.push_back(strPool.str(initPosition(positionLine, strPool).sectorID));
+  }
+
+  size_t adjacentCnt = 0;
+  double ms = timeBest(BENCH_RUN_CNT, [&]() {
+    adjacentCnt = 0;
+    for (string_view sectorID : posIDLst) adjacentCnt += (oldClassify(sectorID) == SectorClass::ADJACENT);
+  });
+  prntBench("unordered_set lookups (old)", ms, 0);
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    adjacentCnt = 0;
+    for (string_view sectorID : posIDLst) adjacentCnt += (cfg_.classify(sectorID) == SectorClass::ADJACENT);
+  });
+  prntBench("Config::classify", ms, 0);
+  string positionsXML;
+  ms = timeBest(BENCH_RUN_CNT, [&]() { positionsXML = cnvrtVRCpof2XML(pofBuf); });
+  prntBench("Positions block", ms, pofBuf.size());
+  cfg_ = Config();
+}//end benchSectorClass
+
+//----------------------------------------------------------------------------
+//what the encoding stage costs a clean (ASCII) alias file, next to the
+//  rest of the conversion, and what a Windows-1252 one costs
+void benchEncoding() {
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  InFileBuf inBuf = makeInFileBuf(aliasBuf);
+  double stageMs = timeBest(BENCH_RUN_CNT, [&]() { normalizeInBuf(inBuf); });
+  prntBench("normalizeInBuf, clean", stageMs, aliasBuf.size());
+
+  opts_.useCache = false;
+  opts_.lint = false;
+  double convertMs = timeBest(BENCH_RUN_CNT, [&]() {
+    vector<AliasSrc> srcLst;
+    srcLst.push_back(makeAliasSrc(aliasBuf, "bench.txt"));
+    string cmdAliasesXML = cnvrtVRCalias2XML(srcLst);
+  });
+  opts_.lint = true;
+  prntBench("whole conversion, clean (--no-lint)", convertMs, aliasBuf.size());
+  cout << "  the stage is " << 100 * stageMs / convertMs << "% of the conversion" << endl;
+
+  string cp1252Buf = aliasBuf;
+  for (size_t charIdx = 0; charIdx < cp1252Buf.size(); charIdx += 97)
+    if (cp1252Buf[charIdx] == 'e') cp1252Buf[charIdx] = '\xE9';
+  double ms = timeBest(BENCH_RUN_CNT, [&]() {
+    InFileBuf cp1252InBuf = makeInFileBuf(cp1252Buf);
+    normalizeInBuf(cp1252InBuf);
+  });
+  prntBench("normalizeInBuf, Windows-1252 (with the copy in)", ms, cp1252Buf.size());
+}//end benchEncoding
+
+//----------------------------------------------------------------------------
+//the whole alias conversion with the lint and with --no-lint
+//  (the warnings go to a null stream, a real file has few of them)
+void benchLint() {
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  opts_.useCache = false;
+  ostream nullStrm(nullptr);
+  streambuf* cerrBuf = cerr.rdbuf(nullStrm.rdbuf());
+  auto convert = [&]() {
+    vector<AliasSrc> srcLst;
+    srcLst.push_back(makeAliasSrc(aliasBuf, "bench.txt"));
+    string cmdAliasesXML = cnvrtVRCalias2XML(srcLst);
+  };
+  opts_.lint = false;
+  double noLintMs = timeBest(BENCH_RUN_CNT, convert);
+  opts_.lint = true;
+  double lintMs = timeBest(BENCH_RUN_CNT, convert);
+  cerr.rdbuf(cerrBuf);
+  opts_.useCache = true;
+  prntBench("--no-lint", noLintMs, aliasBuf.size());
+  prntBench("lint", lintMs, aliasBuf.size());
+  cout << "  the lint adds " << 100 * (lintMs - noLintMs) / noLintMs << "% (target < 10%)" << endl;
+}//end benchLint
+
+//----------------------------------------------------------------------------
+//compiling the generated aliases, then expanding every one of them
+//  (the regression suite should take well under a second)
+void benchAliasEngine() {
+  string const aliasBuf = genAliasBuf(BENCH_ALIAS_CNT);
+  opts_.useCache = false;
+  opts_.lint = false;
+  vector<AliasSrc> srcLst;
+  srcLst.push_back(makeAliasSrc(aliasBuf, "bench.txt"));
+  AliasTable aliasTable;
+  loadAliasTable(srcLst, aliasTable);
+  opts_.lint = true;
+  opts_.useCache = true;
+
+  ExpandCtx ctx;
+  ctx.builtinValLst.assign(size(ALIAS_BUILTIN_LST), "N123AB");
+  ctx.funcValLst["radioname(n123ab)"] = "Speedbird";
+  double ms = timeBest(BENCH_RUN_CNT, [&]() { AliasEngine aliasEngine(aliasTable); });
+  prntBench("compile", ms, 0);
+
+  AliasEngine aliasEngine(aliasTable);
+  vector<string> cmdLineLst;
+  for (size_t aliasIdx = 0; aliasIdx < aliasTable.aliasCnt; ++aliasIdx)
+    cmdLineLst.push_back(string(aliasTable.cmd(aliasIdx)) + " N123AB 5000");
+  size_t expansionLen = 0;
+  string expansion;
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    expansionLen = 0;
+    for (string const& cmdLine : cmdLineLst) {
+      aliasEngine.expand(cmdLine, ctx, expansion);
+      expansionLen += expansion.size();
+    }
+  });
+  prntBench("expand every alias", ms, 0);
+  cout << "  " << 1e6 * ms / cmdLineLst.size() << " ns per command, "
+    << expansionLen << " bytes expanded" << endl;
+}//end benchAliasEngine
+
+//----------------------------------------------------------------------------
+//building the index of 100k generated aliases and the latency of a
+//  prefix query as it is typed (every prefix of random commands)
+void benchCmdPrefixIdx() {
+  size_t const aliasCnt = 100000;
+  string const aliasBuf = genAliasBuf(aliasCnt);
+  opts_.useCache = false;
+  opts_.lint = false;
+  vector<AliasSrc> srcLst;
+  srcLst.push_back(makeAliasSrc(aliasBuf, "bench.txt"));
+  AliasTable aliasTable;
+  loadAliasTable(srcLst, aliasTable);
+  opts_.lint = true;
+  opts_.useCache = true;
+
+  double ms = timeBest(BENCH_RUN_CNT, [&]() { CmdPrefixIdx prefixIdx(aliasTable); });
+  prntBench("build (100k commands)", ms, 0);
+
+  CmdPrefixIdx prefixIdx(aliasTable);
+  TestRng rng(3);
+  vector<string> prefixLst;
+  for (int cmdIdx = 0; cmdIdx < 10000; ++cmdIdx) {
+    string_view cmd = aliasTable.cmd(rng.next(static_cast<uint32_t>(aliasCnt)));
+    for (size_t prefixLen = 1; prefixLen <= cmd.size(); ++prefixLen) prefixLst.emplace_back(cmd.substr(0, prefixLen));
+  }
+  size_t matchCnt = 0;
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    matchCnt = 0;
+    for (string const& prefix : prefixLst) {
+      pair<size_t, size_t> range = prefixIdx.findPrefix(prefix);
+      matchCnt += range.second - range.first;
+    }
+  });
+  prntBench(to_string(prefixLst.size()) + " queries", ms, 0);
+  cout << "  " << 1e3 * ms / prefixLst.size() << " us per query ("
+    << matchCnt / prefixLst.size() << " matches on average)" << endl;
+}//end benchCmdPrefixIdx
+
+//----------------------------------------------------------------------------
+//the frequency of every 8.33 kHz channel name, parsed and formatted
+//  against the stream >> float and to_string() it replaced
+void benchFreq() {
+  vector<string> fieldLst;
+  for (int32_t khz = 118000; khz <= 136995; khz += 5)
+    if (khz % 25 != 20) fieldLst.push_back(to_string(khz / 1000) + '.' + to_string(khz % 1000 + 1000).substr(1));
+  size_t outLen = 0;
+  double ms = timeBest(BENCH_RUN_CNT, [&]() {
+    outLen = 0;
+    for (string const& field : fieldLst) outLen += oldFmtFreq(field).size();
+  });
+  prntBench(to_string(fieldLst.size()) + " channels, stream >> float (old)", ms, 0);
+
+  array<char, FREQ_STR_LEN> freqBuf;
+  ms = timeBest(BENCH_RUN_CNT, [&]() {
+    outLen = 0;
+    for (string const& field : fieldLst) {
+      int32_t freq = NO_FREQ;
+      parseFreq(field, freq);
+      outLen += fmtFreq(freq, freqBuf).size();
+    }
+  });
+  prntBench(to_string(fieldLst.size()) + " channels, parseFreq/fmtFreq", ms, 0);
+}//end benchFreq